@@ -0,0 +1,14 @@
+#!/bin/sh
+
+# Must be launched from the project root directory!
+# Run a benchmark script in each memory mode, and report elapsed time and
+# peak resident set size (requires GNU time).
+
+if [ $# -ne 1 ]; then
+    echo "usage: $0 <script>"
+    exit 1
+fi
+
+for mode in tracing refcount; do
+    /usr/bin/time -f "$mode: %e s, peak RSS %M KB" ./aspic --gc=$mode $1 || exit 1
+done
@@ -1,17 +1,60 @@
 #include "ArrayObject.hpp"
 #include "Object.hpp"
+#include "Error.hpp"
+#include "Hash.hpp"
 
+#include <algorithm>
+#include <new>
+
+
+struct ArrayObject::View
+{
+    Object base; // Never a view, only modified by appending elements
+    size_t offset;
+    size_t length;
+};
 
 ArrayObject::ArrayObject(size_t size):
-    BaseObject()
+    BaseObject(),
+    kind_(INTS),
+    state_(MUTABLE),
+    view_(nullptr),
+    hash_(0)
 {
+    construct_storage();
     if (size > 0) {
-        values_.reserve(size);
+        storage_.ints.reserve(size);
+    }
+}
+
+ArrayObject::ArrayObject(ArrayObject&& array):
+    BaseObject(array),
+    kind_(array.kind_),
+    state_(array.state_),
+    view_(array.view_),
+    hash_(array.hash_)
+{
+    array.view_ = nullptr;
+    switch (kind_) {
+        case INTS:
+            ::new (&storage_.ints) std::vector<int>(std::move(array.storage_.ints));
+            break;
+        case FLOATS:
+            ::new (&storage_.floats) std::vector<double>(std::move(array.storage_.floats));
+            break;
+        case BOOLS:
+            ::new (&storage_.bools) std::vector<uint8_t>(std::move(array.storage_.bools));
+            break;
+        case OBJECTS:
+            ::new (&storage_.objects) std::vector<Object>(std::move(array.storage_.objects));
+            break;
     }
 }
 
 ArrayObject::~ArrayObject()
 {
+    delete view_;
+    destroy_storage();
 }
 
 const char* ArrayObject::class_name() const
@@ -19,68 +62,519 @@ const char* ArrayObject::class_name() const
     return "array";
 }
 
-void ArrayObject::gc_visit()
+void ArrayObject::construct_storage()
+{
+    switch (kind_) {
+        case INTS:    ::new (&storage_.ints) std::vector<int>();        break;
+        case FLOATS:  ::new (&storage_.floats) std::vector<double>();   break;
+        case BOOLS:   ::new (&storage_.bools) std::vector<uint8_t>();   break;
+        case OBJECTS: ::new (&storage_.objects) std::vector<Object>();  break;
+    }
+}
+
+void ArrayObject::destroy_storage()
+{
+    switch (kind_) {
+        case INTS:    storage_.ints.~vector();    break;
+        case FLOATS:  storage_.floats.~vector();  break;
+        case BOOLS:   storage_.bools.~vector();   break;
+        case OBJECTS: storage_.objects.~vector(); break;
+    }
+}
+
+void ArrayObject::gc_visit(gc::Visitor& visitor)
+{
+    if (view_ != nullptr) {
+        view_->base.gc_visit(visitor);
+        return;
+    }
+    // Packed values never reference shared objects
+    if (kind_ == OBJECTS) {
+        for (auto& value: storage_.objects) {
+            value.gc_visit(visitor);
+        }
+    }
+}
+
+BaseObject* ArrayObject::move_to(void* slot)
+{
+    return ::new (slot) ArrayObject(std::move(*this));
+}
+
+size_t ArrayObject::capacity() const
+{
+    switch (kind_) {
+        case INTS:    return storage_.ints.capacity();
+        case FLOATS:  return storage_.floats.capacity();
+        case BOOLS:   return storage_.bools.capacity();
+        case OBJECTS: return storage_.objects.capacity();
+    }
+    return 0;
+}
+
+size_t ArrayObject::external_size() const
 {
-    for (auto& value: values_) {
-        value.gc_visit();
+    if (view_ != nullptr) {
+        return sizeof(View);
+    }
+    switch (kind_) {
+        case INTS:    return capacity() * sizeof(int);
+        case FLOATS:  return capacity() * sizeof(double);
+        case BOOLS:   return capacity() * sizeof(uint8_t);
+        case OBJECTS: return capacity() * sizeof(Object);
     }
+    return 0;
+}
+
+ArrayObject::Kind ArrayObject::kind_of(const Object& object)
+{
+    switch (object.get_type()) {
+        case Object::INT:   return INTS;
+        case Object::FLOAT: return FLOATS;
+        case Object::BOOL:  return BOOLS;
+        default:            return OBJECTS;
+    }
+}
+
+ArrayObject::Kind ArrayObject::get_kind() const
+{
+    return elements().kind_;
 }
 
-ArrayObject* ArrayObject::concat(const ArrayObject& a, const ArrayObject& b)
+const int* ArrayObject::int_data() const
 {
+    return elements().storage_.ints.data() + offset();
+}
+
+const double* ArrayObject::float_data() const
+{
+    return elements().storage_.floats.data() + offset();
+}
+
+const ArrayObject& ArrayObject::elements() const
+{
+    return view_ != nullptr ? *view_->base.get_array() : *this;
+}
+
+size_t ArrayObject::offset() const
+{
+    return view_ != nullptr ? view_->offset : 0;
+}
+
+void ArrayObject::share_elements()
+{
+    ArrayObject* base = new ArrayObject();
+    base->set_kind(kind_);
+    switch (kind_) {
+        case INTS:    base->storage_.ints.swap(storage_.ints);        break;
+        case FLOATS:  base->storage_.floats.swap(storage_.floats);    break;
+        case BOOLS:   base->storage_.bools.swap(storage_.bools);      break;
+        case OBJECTS: base->storage_.objects.swap(storage_.objects);  break;
+    }
+    destroy_storage();
+    kind_ = INTS;
+    construct_storage();
+    view_ = new View{Object::create_array(base), 0, base->size()};
+}
+
+void ArrayObject::materialize()
+{
+    View* view = view_;
+    const ArrayObject& base = *view->base.get_array();
+    view_ = nullptr;
+    destroy_storage();
+    kind_ = base.kind_;
+    switch (kind_) {
+        case INTS:
+        {
+            auto first = base.storage_.ints.begin() + view->offset;
+            ::new (&storage_.ints) std::vector<int>(first, first + view->length);
+            break;
+        }
+        case FLOATS:
+        {
+            auto first = base.storage_.floats.begin() + view->offset;
+            ::new (&storage_.floats) std::vector<double>(first, first + view->length);
+            break;
+        }
+        case BOOLS:
+        {
+            auto first = base.storage_.bools.begin() + view->offset;
+            ::new (&storage_.bools) std::vector<uint8_t>(first, first + view->length);
+            break;
+        }
+        case OBJECTS:
+        {
+            auto first = base.storage_.objects.begin() + view->offset;
+            ::new (&storage_.objects) std::vector<Object>(first, first + view->length);
+            break;
+        }
+    }
+    delete view;
+}
+
+void ArrayObject::set_kind(Kind kind)
+{
+    if (kind == kind_) {
+        return;
+    }
+    size_t reserved = capacity();
+    if (kind == OBJECTS) {
+        std::vector<Object> objects;
+        objects.reserve(reserved);
+        for (size_t i = 0; i < size(); ++i) {
+            objects.push_back(at(i));
+        }
+        destroy_storage();
+        kind_ = OBJECTS;
+        ::new (&storage_.objects) std::vector<Object>(std::move(objects));
+    }
+    else {
+        // Array is empty: only the reserved capacity is kept
+        destroy_storage();
+        kind_ = kind;
+        construct_storage();
+        switch (kind_) {
+            case INTS:   storage_.ints.reserve(reserved);   break;
+            case FLOATS: storage_.floats.reserve(reserved); break;
+            case BOOLS:  storage_.bools.reserve(reserved);  break;
+            default: break;
+        }
+    }
+}
+
+ArrayObject* ArrayObject::concat(ArrayObject& a, const ArrayObject& b)
+{
+    if (a.size() >= VIEW_MIN_SIZE && &b.elements() != &a.elements()) {
+        if (a.view_ == nullptr) {
+            a.share_elements();
+        }
+        ArrayObject* base = a.view_->base.get_array();
+        // Elements past the end of a may be viewed by other arrays
+        if (a.view_->offset + a.view_->length == base->size()) {
+            base->append(b);
+            ArrayObject* array = new ArrayObject();
+            array->view_ = new View{a.view_->base, a.view_->offset, a.view_->length + b.size()};
+            return array;
+        }
+    }
     ArrayObject* array = new ArrayObject(a.size() + b.size());
-    array->values_.insert(array->values_.begin(), a.values_.begin(), a.values_.end());
-    array->values_.insert(array->values_.end(), b.values_.begin(), b.values_.end());
+    array->append(a);
+    array->append(b);
     return array;
 }
 
+ArrayObject* ArrayObject::slice(ArrayObject& array, size_t start, size_t end)
+{
+    size_t length = end > start ? end - start : 0;
+    if (length < VIEW_MIN_SIZE || length * VIEW_MIN_SHARE < array.elements().size()) {
+        ArrayObject* result = new ArrayObject(length);
+        for (size_t i = start; i < end; ++i) {
+            result->push(array.at(i));
+        }
+        return result;
+    }
+    if (array.view_ == nullptr) {
+        array.share_elements();
+    }
+    ArrayObject* result = new ArrayObject();
+    result->view_ = new View{array.view_->base, array.view_->offset + start, length};
+    return result;
+}
+
+void ArrayObject::append(const ArrayObject& array)
+{
+    size_t length = array.size();
+    if (length == 0) {
+        return;
+    }
+    if (view_ != nullptr) {
+        materialize();
+    }
+    const ArrayObject& source = array.elements();
+    size_t first = array.offset();
+    if (size() == 0) {
+        set_kind(source.kind_);
+    }
+    if (kind_ != source.kind_) {
+        for (size_t i = first; i < first + length; ++i) {
+            push(source.at(i));
+        }
+        return;
+    }
+    switch (kind_) {
+        case INTS:
+        {
+            auto begin = source.storage_.ints.begin() + first;
+            storage_.ints.insert(storage_.ints.end(), begin, begin + length);
+            break;
+        }
+        case FLOATS:
+        {
+            auto begin = source.storage_.floats.begin() + first;
+            storage_.floats.insert(storage_.floats.end(), begin, begin + length);
+            break;
+        }
+        case BOOLS:
+        {
+            auto begin = source.storage_.bools.begin() + first;
+            storage_.bools.insert(storage_.bools.end(), begin, begin + length);
+            break;
+        }
+        case OBJECTS:
+        {
+            auto begin = source.storage_.objects.begin() + first;
+            storage_.objects.insert(storage_.objects.end(), begin, begin + length);
+            break;
+        }
+    }
+}
+
 size_t ArrayObject::size() const
 {
-    return values_.size();
+    if (view_ != nullptr) {
+        return view_->length;
+    }
+    switch (kind_) {
+        case INTS:    return storage_.ints.size();
+        case FLOATS:  return storage_.floats.size();
+        case BOOLS:   return storage_.bools.size();
+        case OBJECTS: return storage_.objects.size();
+    }
+    return 0;
 }
 
-Object& ArrayObject::at(int index)
+Object ArrayObject::at(size_t index) const
 {
-    return values_.at(index);
+    if (view_ != nullptr) {
+        return view_->base.get_array()->at(view_->offset + index);
+    }
+    switch (kind_) {
+        case INTS:    return Object::create_int(storage_.ints.at(index));
+        case FLOATS:  return Object::create_float(storage_.floats.at(index));
+        case BOOLS:   return Object::create_bool(storage_.bools.at(index) != 0);
+        case OBJECTS: return storage_.objects.at(index);
+    }
+    return Object::create_null();
 }
 
 void ArrayObject::push(const Object& object)
 {
+    if (state_ != MUTABLE) {
+        throw Error::TypeError("cannot modify a frozen array");
+    }
     // get_value() ensures an identifier reference isn't pushed to the array
-    values_.push_back(object.get_value());
+    const Object& value = object.get_value();
+    if (view_ != nullptr) {
+        ArrayObject* base = view_->base.get_array();
+        if (view_->offset + view_->length == base->size()) {
+            // Elements past the end of the view are not viewed by any other array
+            base->push(value);
+            ++view_->length;
+            return;
+        }
+        materialize();
+    }
+    Kind kind = kind_of(value);
+    if (kind != kind_) {
+        // First element sets the layout, any other type falls back to generic storage
+        set_kind(size() == 0 ? kind : OBJECTS);
+    }
+    switch (kind_) {
+        case INTS:    storage_.ints.push_back(value.get_int());        break;
+        case FLOATS:  storage_.floats.push_back(value.get_float());    break;
+        case BOOLS:   storage_.bools.push_back(value.truthy());        break;
+        case OBJECTS: storage_.objects.push_back(value);               break;
+    }
 }
 
-int ArrayObject::find(const Object& object) const
+void ArrayObject::set(size_t index, const Object& object)
+{
+    if (state_ != MUTABLE) {
+        throw Error::TypeError("cannot modify a frozen array");
+    }
+    const Object& value = object.get_value();
+    if (view_ != nullptr) {
+        // Viewed storage may be shared by other arrays
+        materialize();
+    }
+    if (kind_of(value) != kind_) {
+        set_kind(OBJECTS);
+    }
+    switch (kind_) {
+        case INTS:    storage_.ints[index] = value.get_int();       break;
+        case FLOATS:  storage_.floats[index] = value.get_float();   break;
+        case BOOLS:   storage_.bools[index] = value.truthy();       break;
+        case OBJECTS: storage_.objects[index] = value;              break;
+    }
+}
+
+size_t ArrayObject::find_from(const Object& object, size_t start, size_t end) const
 {
-    for (size_t i = 0; i < values_.size(); ++i) {
-        if (values_[i].equal(object)) {
-            return i;
+    const Object& value = object.get_value();
+    Object::Type type = value.get_type();
+    switch (kind_) {
+        case INTS:
+        {
+            const std::vector<int>& ints = storage_.ints;
+            if (type == Object::INT) {
+                return std::find(ints.begin() + start, ints.begin() + end, value.get_int()) - ints.begin();
+            }
+            if (type == Object::FLOAT) {
+                // int/float comparison is made on floats, as in Object::equal
+                double target = value.get_float();
+                for (size_t i = start; i < end; ++i) {
+                    if (ints[i] == target) {
+                        return i;
+                    }
+                }
+            }
+            return end;
+        }
+        case FLOATS:
+        {
+            const std::vector<double>& floats = storage_.floats;
+            if (type == Object::INT || type == Object::FLOAT) {
+                return std::find(floats.begin() + start, floats.begin() + end, value.get_float()) - floats.begin();
+            }
+            return end;
+        }
+        case BOOLS:
+        {
+            const std::vector<uint8_t>& bools = storage_.bools;
+            if (type == Object::BOOL) {
+                uint8_t target = value.truthy();
+                return std::find(bools.begin() + start, bools.begin() + end, target) - bools.begin();
+            }
+            return end;
+        }
+        case OBJECTS:
+        {
+            const std::vector<Object>& objects = storage_.objects;
+            for (size_t i = start; i < end; ++i) {
+                if (objects[i].equal(value)) {
+                    return i;
+                }
+            }
+            return end;
         }
     }
-    return -1;
+    return end;
+}
+
+int ArrayObject::find(const Object& object) const
+{
+    size_t first = offset();
+    size_t last = first + size();
+    size_t index = elements().find_from(object, first, last);
+    return index < last ? index - first : -1;
 }
 
 int ArrayObject::count(const Object& object) const
 {
+    const ArrayObject& source = elements();
+    size_t last = offset() + size();
     int count = 0;
-    for (auto& value: values_) {
-        if (value.equal(object)) {
-            ++count;
-        }
+    for (size_t i = source.find_from(object, offset(), last); i < last; i = source.find_from(object, i + 1, last)) {
+        ++count;
     }
     return count;
 }
 
+void ArrayObject::freeze()
+{
+    std::vector<ArrayObject*> frozen;
+    try {
+        freeze(frozen);
+    }
+    catch (...) {
+        // Nested arrays frozen before the error become mutable again
+        for (ArrayObject* array: frozen) {
+            array->state_ = MUTABLE;
+        }
+        throw;
+    }
+}
+
+void ArrayObject::freeze(std::vector<ArrayObject*>& frozen)
+{
+    if (state_ == FROZEN) {
+        return;
+    }
+    if (state_ == FREEZING) {
+        throw Error::ValueError("cannot freeze an array containing itself");
+    }
+    state_ = FREEZING;
+    uint64_t hash = Hash::integer(size());
+    try {
+        for (size_t i = 0; i < size(); ++i) {
+            Object element = at(i);
+            if (element.get_type() == Object::ARRAY) {
+                element.get_array()->freeze(frozen);
+            }
+            hash = Hash::mix(hash ^ std::hash<Object>{}(element), 0x9e3779b97f4a7c15ull);
+        }
+    }
+    catch (...) {
+        state_ = MUTABLE;
+        throw;
+    }
+    hash_ = hash;
+    state_ = FROZEN;
+    frozen.push_back(this);
+}
+
+bool ArrayObject::is_frozen() const
+{
+    return state_ == FROZEN;
+}
+
+size_t ArrayObject::hash() const
+{
+    return hash_;
+}
+
 bool ArrayObject::eq(const ArrayObject& array) const
 {
     if (this == &array) {
         return true;
     }
+    // Frozen arrays with different hashes can't be equal
+    if (state_ == FROZEN && array.state_ == FROZEN && hash_ != array.hash_) {
+        return false;
+    }
     if (size() != array.size()) {
         return false;
     }
-    return std::equal(values_.begin(), values_.end(), array.values_.begin(),
-        [](const Object& left, const Object& right) {
-            return left.equal(right);
-        });
+    const ArrayObject& left = elements();
+    const ArrayObject& right = array.elements();
+    if (left.kind_ == right.kind_) {
+        size_t first = offset();
+        size_t last = first + size();
+        size_t other = array.offset();
+        switch (left.kind_) {
+            case INTS:
+                return std::equal(left.storage_.ints.begin() + first, left.storage_.ints.begin() + last,
+                    right.storage_.ints.begin() + other);
+            case FLOATS:
+                return std::equal(left.storage_.floats.begin() + first, left.storage_.floats.begin() + last,
+                    right.storage_.floats.begin() + other);
+            case BOOLS:
+                return std::equal(left.storage_.bools.begin() + first, left.storage_.bools.begin() + last,
+                    right.storage_.bools.begin() + other);
+            case OBJECTS:
+                return std::equal(left.storage_.objects.begin() + first, left.storage_.objects.begin() + last,
+                    right.storage_.objects.begin() + other,
+                    [](const Object& a, const Object& b) {
+                        return a.equal(b);
+                    });
+        }
+    }
+    // Different layouts: int and float values may still be equal
+    for (size_t i = 0; i < size(); ++i) {
+        if (!at(i).equal(array.at(i))) {
+            return false;
+        }
+    }
+    return true;
 }
@@ -3,16 +3,40 @@
 
 #include "BaseObject.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 class Object;
 
 /**
- * A vector of Object. Implemented as a wrapper around std::vector
+ * A vector of Object.
+ *
+ * While all elements share the same int, float or bool type, they are packed
+ * in a vector of that C++ type instead of a vector of tagged Object values.
+ * The first element of another type converts the array to generic storage.
+ *
+ * A large slice is a view: it references a range of another array's storage
+ * instead of copying it. Viewed storage is never modified in place, the view
+ * copies its elements when it is modified (copy-on-write).
+ *
+ * A frozen array can't be modified anymore, and is hashable: its structural
+ * hash is computed once when it is frozen.
  */
 class ArrayObject: public BaseObject
 {
 public:
+    /**
+     * Storage layout of the elements
+     */
+    enum Kind
+    {
+        INTS,   // std::vector<int>
+        FLOATS, // std::vector<double>
+        BOOLS,  // std::vector<uint8_t>
+        OBJECTS // std::vector<Object>, any types
+    };
+
     ArrayObject(size_t size = 0);
     ~ArrayObject();
 
@@ -20,14 +44,41 @@ public:
 
     /**
      * Merge two arrays into a new one
+     * If a holds at least VIEW_MIN_SIZE elements, b is appended to the
+     * elements of a, which the new array views: a then becomes a view too.
+     * Repeated concatenation (a = a + [x]) thus only copies appended elements.
+     */
+    static ArrayObject* concat(ArrayObject& a, const ArrayObject& b);
+
+    /**
+     * Create an array of elements in range [start, end) of the given array.
+     * Slices of at least VIEW_MIN_SIZE elements, covering at least
+     * 1 / VIEW_MIN_SHARE of the viewed elements, are views: the source array
+     * then becomes a view too, both sharing its elements.
      */
-    static ArrayObject* concat(const ArrayObject& a, const ArrayObject& b);
+    static ArrayObject* slice(ArrayObject& array, size_t start, size_t end);
+
+    // Smaller slices are copied
+    static const size_t VIEW_MIN_SIZE = 16;
+    // Narrower slices are copied too, so they don't keep a large array alive
+    static const size_t VIEW_MIN_SHARE = 4;
 
     /**
      * Get array length
      */
     size_t size() const;
 
+    /**
+     * Get storage layout
+     */
+    Kind get_kind() const;
+
+    /**
+     * Get packed elements (kind must be INTS or FLOATS)
+     */
+    const int* int_data() const;
+    const double* float_data() const;
+
     /**
      * Compare two arrays
      */
@@ -35,9 +86,30 @@ public:
 
     /**
      * Append value to end of array
+     * Throw TypeError if array is frozen
      */
     void push(const Object& object);
 
+    /**
+     * Replace value at given index (index must be in range)
+     * Throw TypeError if array is frozen
+     */
+    void set(size_t index, const Object& object);
+
+    /**
+     * Make array immutable and hashable, nested arrays are frozen too
+     * Throw TypeError if an element isn't hashable, ValueError if the array
+     * contains itself. Arrays are then left unchanged, nested arrays included.
+     */
+    void freeze();
+
+    bool is_frozen() const;
+
+    /**
+     * Get structural hash (array must be frozen)
+     */
+    size_t hash() const;
+
     /**
      * Return first index of given value, -1 otherwise
      */
@@ -51,15 +123,104 @@ public:
     /**
      * Get value at given index
      */
-    Object& at(int index);
+    Object at(size_t index) const;
+
+    void gc_visit(gc::Visitor& visitor) override;
+
+    BaseObject* move_to(void* slot) override;
+
+    size_t external_size() const override;
 
 private:
     ArrayObject(const ArrayObject&) = delete;
     ArrayObject& operator=(const ArrayObject&) = delete;
 
-    void gc_visit() override;
+    ArrayObject(ArrayObject&& array);
+
+    /**
+     * Construct the vector matching kind_, or destroy it
+     */
+    void construct_storage();
+    void destroy_storage();
+
+    /**
+     * Get number of elements the storage can hold without reallocating
+     */
+    size_t capacity() const;
+
+    /**
+     * Change storage layout, elements are converted to the new layout.
+     * Packed layouts can only be set on empty arrays.
+     */
+    void set_kind(Kind kind);
+
+    /**
+     * Append all elements of another array
+     */
+    void append(const ArrayObject& array);
+
+    /**
+     * Get array holding the elements (the viewed array for a view), and
+     * index of the first element in it
+     */
+    const ArrayObject& elements() const;
+    size_t offset() const;
+
+    /**
+     * Move elements to a new array, which is then viewed by this array
+     */
+    void share_elements();
 
-    std::vector<Object> values_;
+    /**
+     * Copy viewed elements, so that this array is no longer a view
+     */
+    void materialize();
+
+    /**
+     * Get storage layout matching the type of a value
+     */
+    static Kind kind_of(const Object& object);
+
+    /**
+     * Find index of first element equal to object in elements [start, end)
+     * of the storage (not accounting for view offset)
+     * @return index, or end if not found
+     */
+    size_t find_from(const Object& object, size_t start, size_t end) const;
+
+    // Only the member matching kind_ is constructed
+    union Storage
+    {
+        Storage() {}
+        ~Storage() {}
+
+        std::vector<int> ints;
+        std::vector<double> floats;
+        std::vector<uint8_t> bools;
+        std::vector<Object> objects;
+    };
+
+    // Range of a viewed array
+    struct View;
+
+    /**
+     * Freeze array and its elements, and add arrays frozen by this call to
+     * the given list
+     */
+    void freeze(std::vector<ArrayObject*>& frozen);
+
+    enum State: uint8_t
+    {
+        MUTABLE,
+        FREEZING, // Elements are being frozen, to detect cycles
+        FROZEN
+    };
+
+    Kind kind_;
+    State state_;
+    Storage storage_; // Empty for a view
+    View* view_;      // nullptr if the array owns its elements
+    size_t hash_;     // Structural hash, once frozen
 };
 
 #endif
@@ -1,31 +1,35 @@
 #include "BaseObject.hpp"
-#include "SymbolTable.hpp"
+#include "gc/Heap.hpp"
 
 
 BaseObject::BaseObject():
-    marked_(0)
+    ref_count_(0),
+    rc_buffer_index_(UINT32_MAX),
+    rc_color_(0),
+    alloc_site_(0)
 {
-    SymbolTable::track_object(this);
 }
 
 BaseObject::~BaseObject()
 {
 }
 
+size_t BaseObject::external_size() const
+{
+    return 0;
+}
+
 bool BaseObject::is_marked() const
 {
-    return marked_;
+    return gc::Heap::is_marked(this);
 }
 
-void BaseObject::clear_mark()
+void* BaseObject::operator new(size_t size)
 {
-    marked_ = false;
+    return gc::Heap::allocate(size);
 }
 
-void BaseObject::mark()
+void BaseObject::operator delete(void* ptr)
 {
-    if (!marked_) {
-        marked_ = true;
-        gc_visit();
-    }
+    gc::Heap::deallocate(ptr);
 }
@@ -1,8 +1,14 @@
 #ifndef ASPIC_BASE_OBJECT_HPP
 #define ASPIC_BASE_OBJECT_HPP
 
+#include <cstddef>
+#include <cstdint>
+
+namespace gc { class Visitor; class RefCount; class Profiler; }
+
 /**
  * Base class for objects which are handled using reference
+ * Instances are allocated in the garbage collected heap (see gc::Heap)
  */
 class BaseObject
 {
@@ -12,29 +18,45 @@ public:
     virtual const char* class_name() const = 0;
 
     /**
-     * Mark object as still active
+     * Get the object marked status
      */
-    void mark();
+    bool is_marked() const;
+
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr);
 
     /**
-     * Reset the active mark as 'false'
+     * Callback when object has been marked as still active by GC: invoke
+     * visitor on each Object value held by this object
      */
-    void clear_mark();
+    virtual void gc_visit(gc::Visitor& visitor) = 0;
 
     /**
-     * Get the object marked status
+     * Move-construct object into another heap slot (see gc::Heap::compact)
+     * @return moved object
      */
-    bool is_marked() const;
+    virtual BaseObject* move_to(void* slot) = 0;
+
+    /**
+     * Approximate size of the memory owned by the object outside of its heap
+     * slot, such as container buffers (see gc::Profiler)
+     */
+    virtual size_t external_size() const;
 
 protected:
     BaseObject();
 
-    /**
-     * Callback when object has been marked as still active by GC
-     */
-    virtual void gc_visit() = 0;
+private:
+    friend class gc::RefCount;
+    friend class gc::Profiler;
+
+    // Reference counting mode only (see gc::RefCount)
+    uint32_t ref_count_;
+    uint32_t rc_buffer_index_;
+    uint8_t rc_color_;
 
-    bool marked_;
+    // Heap profiling only (see gc::Profiler)
+    uint32_t alloc_site_;
 };
 
 #endif
@@ -0,0 +1,310 @@
+#include "BitsetObject.hpp"
+#include "ArrayObject.hpp"
+#include "Object.hpp"
+#include "Error.hpp"
+
+#include <new>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define ASPIC_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Scalar kernels
+// -----------------------------------------------------------------------------
+
+size_t popcount_scalar(const uint64_t* words, size_t size)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        count += __builtin_popcountll(words[i]);
+    }
+    return count;
+}
+
+template <BitsetObject::Operation Op>
+inline uint64_t combine_word(uint64_t a, uint64_t b)
+{
+    switch (Op) {
+        case BitsetObject::AND:
+            return a & b;
+        case BitsetObject::OR:
+            return a | b;
+        case BitsetObject::XOR:
+            return a ^ b;
+        case BitsetObject::ANDNOT:
+            return a & ~b;
+    }
+    return 0; // Unreachable, fix -Wreturn-type
+}
+
+template <BitsetObject::Operation Op>
+void combine_scalar(uint64_t* result, const uint64_t* a, const uint64_t* b, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = combine_word<Op>(a[i], b[i]);
+    }
+}
+
+#ifdef ASPIC_X86_SIMD
+
+// SSE2 and POPCNT kernels
+// -----------------------------------------------------------------------------
+
+__attribute__((target("popcnt")))
+size_t popcount_popcnt(const uint64_t* words, size_t size)
+{
+    // Independent accumulators hide the popcnt latency
+    size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        c0 += __builtin_popcountll(words[i]);
+        c1 += __builtin_popcountll(words[i + 1]);
+        c2 += __builtin_popcountll(words[i + 2]);
+        c3 += __builtin_popcountll(words[i + 3]);
+    }
+    for (; i < size; ++i) {
+        c0 += __builtin_popcountll(words[i]);
+    }
+    return c0 + c1 + c2 + c3;
+}
+
+template <BitsetObject::Operation Op>
+inline __m128i combine_sse2(__m128i a, __m128i b)
+{
+    switch (Op) {
+        case BitsetObject::AND:
+            return _mm_and_si128(a, b);
+        case BitsetObject::OR:
+            return _mm_or_si128(a, b);
+        case BitsetObject::XOR:
+            return _mm_xor_si128(a, b);
+        case BitsetObject::ANDNOT:
+            return _mm_andnot_si128(b, a);
+    }
+    return a; // Unreachable, fix -Wreturn-type
+}
+
+template <BitsetObject::Operation Op>
+void combine_sse2(uint64_t* result, const uint64_t* a, const uint64_t* b, size_t size)
+{
+    size_t i = 0;
+    for (; i + 2 <= size; i += 2) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i), combine_sse2<Op>(va, vb));
+    }
+    combine_scalar<Op>(result + i, a + i, b + i, size - i);
+}
+
+// AVX2 kernels (selected at runtime if supported by the CPU)
+// -----------------------------------------------------------------------------
+
+__attribute__((target("avx2,popcnt")))
+size_t popcount_avx2(const uint64_t* words, size_t size)
+{
+    // Count bits of each nibble with a lookup table, then sum bytes per 64-bit lane
+    const __m256i lookup = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+    );
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+        __m256i low = _mm256_and_si256(values, low_mask);
+        __m256i high = _mm256_and_si256(_mm256_srli_epi16(values, 4), low_mask);
+        __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    size_t count = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < size; ++i) {
+        count += __builtin_popcountll(words[i]);
+    }
+    return count;
+}
+
+template <BitsetObject::Operation Op>
+__attribute__((target("avx2")))
+inline __m256i combine_avx2(__m256i a, __m256i b)
+{
+    switch (Op) {
+        case BitsetObject::AND:
+            return _mm256_and_si256(a, b);
+        case BitsetObject::OR:
+            return _mm256_or_si256(a, b);
+        case BitsetObject::XOR:
+            return _mm256_xor_si256(a, b);
+        case BitsetObject::ANDNOT:
+            return _mm256_andnot_si256(b, a);
+    }
+    return a; // Unreachable, fix -Wreturn-type
+}
+
+template <BitsetObject::Operation Op>
+__attribute__((target("avx2")))
+void combine_avx2(uint64_t* result, const uint64_t* a, const uint64_t* b, size_t size)
+{
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + i), combine_avx2<Op>(va, vb));
+    }
+    combine_scalar<Op>(result + i, a + i, b + i, size - i);
+}
+
+#endif
+
+// Kernel selection
+// -----------------------------------------------------------------------------
+
+typedef void (*CombineKernel)(uint64_t*, const uint64_t*, const uint64_t*, size_t);
+
+struct Kernels
+{
+    size_t (*popcount)(const uint64_t*, size_t);
+    CombineKernel combine[4]; // Indexed by BitsetObject::Operation
+};
+
+Kernels select_kernels()
+{
+#ifdef ASPIC_X86_SIMD
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        return Kernels{
+            popcount_avx2,
+            {
+                combine_avx2<BitsetObject::AND>, combine_avx2<BitsetObject::OR>,
+                combine_avx2<BitsetObject::XOR>, combine_avx2<BitsetObject::ANDNOT>
+            }
+        };
+    }
+    return Kernels{
+        __builtin_cpu_supports("popcnt") ? popcount_popcnt : popcount_scalar,
+        {
+            combine_sse2<BitsetObject::AND>, combine_sse2<BitsetObject::OR>,
+            combine_sse2<BitsetObject::XOR>, combine_sse2<BitsetObject::ANDNOT>
+        }
+    };
+#else
+    return Kernels{
+        popcount_scalar,
+        {
+            combine_scalar<BitsetObject::AND>, combine_scalar<BitsetObject::OR>,
+            combine_scalar<BitsetObject::XOR>, combine_scalar<BitsetObject::ANDNOT>
+        }
+    };
+#endif
+}
+
+const Kernels& kernels()
+{
+    static const Kernels selected = select_kernels();
+    return selected;
+}
+
+}
+
+
+BitsetObject::BitsetObject(size_t size):
+    BaseObject(),
+    words_((size + 63) / 64, 0),
+    size_(size)
+{
+}
+
+BitsetObject::BitsetObject(BitsetObject&& bitset):
+    BaseObject(bitset),
+    words_(std::move(bitset.words_)),
+    size_(bitset.size_)
+{
+}
+
+BitsetObject::~BitsetObject()
+{
+}
+
+const char* BitsetObject::class_name() const
+{
+    return "bitset";
+}
+
+size_t BitsetObject::size() const
+{
+    return size_;
+}
+
+size_t BitsetObject::position(int index) const
+{
+    if (index < 0 || static_cast<size_t>(index) >= size_) {
+        throw Error::IndexError(index);
+    }
+    return static_cast<size_t>(index);
+}
+
+void BitsetObject::set(int index)
+{
+    size_t i = position(index);
+    words_[i / 64] |= uint64_t(1) << (i % 64);
+}
+
+void BitsetObject::clear(int index)
+{
+    size_t i = position(index);
+    words_[i / 64] &= ~(uint64_t(1) << (i % 64));
+}
+
+bool BitsetObject::test(int index) const
+{
+    size_t i = position(index);
+    return (words_[i / 64] >> (i % 64)) & 1;
+}
+
+size_t BitsetObject::count() const
+{
+    return kernels().popcount(words_.data(), words_.size());
+}
+
+ArrayObject* BitsetObject::indexes() const
+{
+    ArrayObject* array = new ArrayObject(count());
+    for_each_index([array](size_t index) {
+        array->push(Object::create_int(static_cast<int>(index)));
+    });
+    return array;
+}
+
+BitsetObject* BitsetObject::combine(Operation operation, const BitsetObject& a, const BitsetObject& b)
+{
+    if (a.size_ != b.size_) {
+        throw Error::ValueError("bitsets must have the same size");
+    }
+    BitsetObject* result = new BitsetObject(a.size_);
+    kernels().combine[operation](result->words_.data(), a.words_.data(), b.words_.data(), a.words_.size());
+    return result;
+}
+
+bool BitsetObject::eq(const BitsetObject& bitset) const
+{
+    return size_ == bitset.size_ && words_ == bitset.words_;
+}
+
+void BitsetObject::gc_visit(gc::Visitor&)
+{
+    // Bits never reference shared objects
+}
+
+BaseObject* BitsetObject::move_to(void* slot)
+{
+    return ::new (slot) BitsetObject(std::move(*this));
+}
+
+size_t BitsetObject::external_size() const
+{
+    return words_.capacity() * sizeof(uint64_t);
+}
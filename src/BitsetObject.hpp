@@ -0,0 +1,105 @@
+#ifndef ASPIC_BITSET_OBJECT_HPP
+#define ASPIC_BITSET_OBJECT_HPP
+
+#include "BaseObject.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class ArrayObject;
+
+/**
+ * A fixed-size set of bits, packed in 64-bit words
+ *
+ * Popcount and bitwise operations between bitsets run on whole words, with
+ * AVX2 or SSE2 kernels selected at runtime. Bits beyond size in the last
+ * word are always 0.
+ */
+class BitsetObject: public BaseObject
+{
+public:
+    /**
+     * @param size: number of bits, all initially cleared
+     */
+    explicit BitsetObject(size_t size);
+    ~BitsetObject();
+
+    const char* class_name() const override;
+
+    /**
+     * Get number of bits
+     */
+    size_t size() const;
+
+    /**
+     * Set, clear or get the bit at index
+     * Throw IndexError if index is out of range
+     */
+    void set(int index);
+    void clear(int index);
+    bool test(int index) const;
+
+    /**
+     * Get number of set bits
+     */
+    size_t count() const;
+
+    /**
+     * Get indexes of set bits, in increasing order
+     */
+    ArrayObject* indexes() const;
+
+    /**
+     * Call f(index) on each set bit, in increasing order
+     */
+    template <class F>
+    void for_each_index(F f) const
+    {
+        for (size_t i = 0; i < words_.size(); ++i) {
+            for (uint64_t word = words_[i]; word != 0; word &= word - 1) {
+                f(i * 64 + __builtin_ctzll(word));
+            }
+        }
+    }
+
+    enum Operation
+    {
+        AND,
+        OR,
+        XOR,
+        ANDNOT
+    };
+
+    /**
+     * Create a new bitset, combining bitsets of same size word by word
+     * Throw ValueError if sizes differ
+     */
+    static BitsetObject* combine(Operation operation, const BitsetObject& a, const BitsetObject& b);
+
+    /**
+     * Compare two bitsets
+     */
+    bool eq(const BitsetObject& bitset) const;
+
+    void gc_visit(gc::Visitor& visitor) override;
+
+    BaseObject* move_to(void* slot) override;
+
+    size_t external_size() const override;
+
+private:
+    BitsetObject(const BitsetObject&) = delete;
+    BitsetObject& operator=(const BitsetObject&) = delete;
+
+    BitsetObject(BitsetObject&& bitset);
+
+    /**
+     * Check index range
+     */
+    size_t position(int index) const;
+
+    std::vector<uint64_t> words_;
+    size_t size_;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#include "BloomFilterObject.hpp"
+#include "Object.hpp"
+#include "Error.hpp"
+#include "Hash.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <new>
+
+
+BloomFilterObject::BloomFilterObject(size_t capacity, double error_rate):
+    BaseObject()
+{
+    // Optimal sizes: m = -n ln(p) / ln(2)^2 bits, k = m / n ln(2) hashes
+    const double ln2 = std::log(2.0);
+    double bits = std::ceil(-static_cast<double>(capacity) * std::log(error_rate) / (ln2 * ln2));
+    words_.assign((static_cast<size_t>(bits) + 63) / 64, 0);
+    bit_count_ = words_.size() * 64;
+    hash_count_ = std::max<size_t>(1, std::lround(static_cast<double>(bit_count_) / capacity * ln2));
+}
+
+BloomFilterObject::BloomFilterObject(size_t bit_count, size_t hash_count):
+    BaseObject(),
+    words_(bit_count / 64, 0),
+    bit_count_(bit_count),
+    hash_count_(hash_count)
+{
+}
+
+BloomFilterObject::BloomFilterObject(BloomFilterObject&& filter):
+    BaseObject(filter),
+    words_(std::move(filter.words_)),
+    bit_count_(filter.bit_count_),
+    hash_count_(filter.hash_count_)
+{
+}
+
+BloomFilterObject::~BloomFilterObject()
+{
+}
+
+const char* BloomFilterObject::class_name() const
+{
+    return "bloom";
+}
+
+size_t BloomFilterObject::bit_count() const
+{
+    return bit_count_;
+}
+
+size_t BloomFilterObject::hash_count() const
+{
+    return hash_count_;
+}
+
+void BloomFilterObject::add(const Object& value)
+{
+    uint64_t hash = Hash::scramble(std::hash<Object>{}(value.get_value()));
+    // Second hash is odd, so probes don't repeat
+    uint64_t step = Hash::mix(hash, 0x9e3779b97f4a7c15ull) | 1;
+    for (size_t i = 0; i < hash_count_; ++i, hash += step) {
+        uint64_t bit = Hash::reduce(hash, bit_count_);
+        words_[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+}
+
+bool BloomFilterObject::contains(const Object& value) const
+{
+    uint64_t hash = Hash::scramble(std::hash<Object>{}(value.get_value()));
+    uint64_t step = Hash::mix(hash, 0x9e3779b97f4a7c15ull) | 1;
+    for (size_t i = 0; i < hash_count_; ++i, hash += step) {
+        uint64_t bit = Hash::reduce(hash, bit_count_);
+        if ((words_[bit / 64] & (uint64_t(1) << (bit % 64))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BloomFilterObject::eq(const BloomFilterObject& filter) const
+{
+    return hash_count_ == filter.hash_count_ && words_ == filter.words_;
+}
+
+BloomFilterObject* BloomFilterObject::merge(const BloomFilterObject& a, const BloomFilterObject& b)
+{
+    if (a.bit_count_ != b.bit_count_ || a.hash_count_ != b.hash_count_) {
+        throw Error::ValueError("bloom filters must have the same capacity and error rate");
+    }
+    BloomFilterObject* filter = new BloomFilterObject(a.bit_count_, a.hash_count_);
+    for (size_t i = 0; i < filter->words_.size(); ++i) {
+        filter->words_[i] = a.words_[i] | b.words_[i];
+    }
+    return filter;
+}
+
+BaseObject* BloomFilterObject::move_to(void* slot)
+{
+    return ::new (slot) BloomFilterObject(std::move(*this));
+}
+
+size_t BloomFilterObject::external_size() const
+{
+    return words_.capacity() * sizeof(uint64_t);
+}
+
+void BloomFilterObject::gc_visit(gc::Visitor&)
+{
+    // Values are only hashed, never stored
+}
@@ -0,0 +1,72 @@
+#ifndef ASPIC_BLOOM_FILTER_OBJECT_HPP
+#define ASPIC_BLOOM_FILTER_OBJECT_HPP
+
+#include "BaseObject.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class Object;
+
+/**
+ * A Bloom filter: approximate membership of hashable values, in fixed memory
+ *
+ * A value sets hash_count bits, derived from its Object hash by double
+ * hashing. Lookups may give false positives, never false negatives.
+ */
+class BloomFilterObject: public BaseObject
+{
+public:
+    /**
+     * Size the filter so that the false positive rate stays under
+     * error_rate until capacity values are added
+     */
+    BloomFilterObject(size_t capacity, double error_rate);
+    ~BloomFilterObject();
+
+    const char* class_name() const override;
+
+    size_t bit_count() const;
+    size_t hash_count() const;
+
+    /**
+     * Add a value
+     */
+    void add(const Object& value);
+
+    /**
+     * Check if a value may have been added
+     */
+    bool contains(const Object& value) const;
+
+    /**
+     * Compare two filters
+     */
+    bool eq(const BloomFilterObject& filter) const;
+
+    /**
+     * Create a filter holding values of both filters
+     * Throw ValueError if filters have different sizes
+     */
+    static BloomFilterObject* merge(const BloomFilterObject& a, const BloomFilterObject& b);
+
+    void gc_visit(gc::Visitor& visitor) override;
+
+    BaseObject* move_to(void* slot) override;
+
+    size_t external_size() const override;
+
+private:
+    BloomFilterObject(const BloomFilterObject&) = delete;
+    BloomFilterObject& operator=(const BloomFilterObject&) = delete;
+
+    BloomFilterObject(BloomFilterObject&& filter);
+
+    BloomFilterObject(size_t bit_count, size_t hash_count);
+
+    std::vector<uint64_t> words_;
+    size_t bit_count_;
+    size_t hash_count_;
+};
+
+#endif
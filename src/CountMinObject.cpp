@@ -0,0 +1,106 @@
+#include "CountMinObject.hpp"
+#include "Object.hpp"
+#include "Error.hpp"
+#include "Hash.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <new>
+
+
+// Standard sizes: width = e / epsilon, depth = ln(1 / delta)
+CountMinObject::CountMinObject(double epsilon, double delta):
+    CountMinObject(static_cast<size_t>(std::ceil(std::exp(1.0) / epsilon)),
+        std::max<size_t>(1, static_cast<size_t>(std::ceil(std::log(1 / delta)))))
+{
+}
+
+CountMinObject::CountMinObject(size_t width, size_t depth):
+    BaseObject(),
+    counters_(width * depth, 0),
+    width_(width),
+    depth_(depth)
+{
+}
+
+CountMinObject::CountMinObject(CountMinObject&& sketch):
+    BaseObject(sketch),
+    counters_(std::move(sketch.counters_)),
+    width_(sketch.width_),
+    depth_(sketch.depth_)
+{
+}
+
+CountMinObject::~CountMinObject()
+{
+}
+
+const char* CountMinObject::class_name() const
+{
+    return "cms";
+}
+
+size_t CountMinObject::width() const
+{
+    return width_;
+}
+
+size_t CountMinObject::depth() const
+{
+    return depth_;
+}
+
+void CountMinObject::add(const Object& value, uint64_t count)
+{
+    uint64_t hash = Hash::scramble(std::hash<Object>{}(value.get_value()));
+    uint64_t step = Hash::mix(hash, 0x9e3779b97f4a7c15ull) | 1;
+    for (size_t row = 0; row < depth_; ++row, hash += step) {
+        uint64_t& counter = counters_[row * width_ + Hash::reduce(hash, width_)];
+        // Saturate rather than wrap around
+        counter = counter + count < counter ? UINT64_MAX : counter + count;
+    }
+}
+
+uint64_t CountMinObject::count(const Object& value) const
+{
+    uint64_t hash = Hash::scramble(std::hash<Object>{}(value.get_value()));
+    uint64_t step = Hash::mix(hash, 0x9e3779b97f4a7c15ull) | 1;
+    uint64_t result = UINT64_MAX;
+    for (size_t row = 0; row < depth_; ++row, hash += step) {
+        result = std::min(result, counters_[row * width_ + Hash::reduce(hash, width_)]);
+    }
+    return result;
+}
+
+bool CountMinObject::eq(const CountMinObject& sketch) const
+{
+    return width_ == sketch.width_ && counters_ == sketch.counters_;
+}
+
+CountMinObject* CountMinObject::merge(const CountMinObject& a, const CountMinObject& b)
+{
+    if (a.width_ != b.width_ || a.depth_ != b.depth_) {
+        throw Error::ValueError("count-min sketches must have the same error bounds");
+    }
+    CountMinObject* sketch = new CountMinObject(a.width_, a.depth_);
+    for (size_t i = 0; i < sketch->counters_.size(); ++i) {
+        uint64_t sum = a.counters_[i] + b.counters_[i];
+        sketch->counters_[i] = sum < a.counters_[i] ? UINT64_MAX : sum;
+    }
+    return sketch;
+}
+
+BaseObject* CountMinObject::move_to(void* slot)
+{
+    return ::new (slot) CountMinObject(std::move(*this));
+}
+
+size_t CountMinObject::external_size() const
+{
+    return counters_.capacity() * sizeof(uint64_t);
+}
+
+void CountMinObject::gc_visit(gc::Visitor&)
+{
+    // Values are only hashed, never stored
+}
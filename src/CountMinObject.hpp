@@ -0,0 +1,74 @@
+#ifndef ASPIC_COUNT_MIN_OBJECT_HPP
+#define ASPIC_COUNT_MIN_OBJECT_HPP
+
+#include "BaseObject.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class Object;
+
+/**
+ * A Count-Min sketch: approximate frequencies of hashable values, in fixed
+ * memory
+ *
+ * Each of depth rows holds width counters. A value increments one counter
+ * per row, selected by double hashing of its Object hash, and its count is
+ * the smallest of them: it's never underestimated, and overestimated by at
+ * most epsilon times the total count with probability 1 - delta.
+ */
+class CountMinObject: public BaseObject
+{
+public:
+    /**
+     * Size the sketch from error bounds, both in (0, 1)
+     */
+    CountMinObject(double epsilon, double delta);
+    ~CountMinObject();
+
+    const char* class_name() const override;
+
+    size_t width() const;
+    size_t depth() const;
+
+    /**
+     * Add count occurrences of a value
+     */
+    void add(const Object& value, uint64_t count);
+
+    /**
+     * Estimate the number of occurrences of a value
+     */
+    uint64_t count(const Object& value) const;
+
+    /**
+     * Compare two sketches
+     */
+    bool eq(const CountMinObject& sketch) const;
+
+    /**
+     * Create a sketch counting values of both sketches
+     * Throw ValueError if sketches have different sizes
+     */
+    static CountMinObject* merge(const CountMinObject& a, const CountMinObject& b);
+
+    void gc_visit(gc::Visitor& visitor) override;
+
+    BaseObject* move_to(void* slot) override;
+
+    size_t external_size() const override;
+
+private:
+    CountMinObject(const CountMinObject&) = delete;
+    CountMinObject& operator=(const CountMinObject&) = delete;
+
+    CountMinObject(CountMinObject&& sketch);
+
+    CountMinObject(size_t width, size_t depth);
+
+    std::vector<uint64_t> counters_; // depth rows of width counters
+    size_t width_;
+    size_t depth_;
+};
+
+#endif
@@ -0,0 +1,99 @@
+#include "DequeObject.hpp"
+#include "Error.hpp"
+
+#include <algorithm>
+#include <new>
+
+
+DequeObject::DequeObject():
+    BaseObject()
+{
+}
+
+DequeObject::DequeObject(DequeObject&& deque):
+    BaseObject(deque),
+    values_(std::move(deque.values_))
+{
+}
+
+DequeObject::~DequeObject()
+{
+}
+
+const char* DequeObject::class_name() const
+{
+    return "deque";
+}
+
+size_t DequeObject::size() const
+{
+    return values_.size();
+}
+
+void DequeObject::push_front(const Object& object)
+{
+    // get_value() ensures an identifier reference isn't pushed to the deque
+    values_.push_front(object.get_value());
+}
+
+void DequeObject::push_back(const Object& object)
+{
+    values_.push_back(object.get_value());
+}
+
+void DequeObject::check_not_empty() const
+{
+    if (values_.empty()) {
+        throw Error::ValueError("deque is empty");
+    }
+}
+
+Object DequeObject::pop_front()
+{
+    check_not_empty();
+    Object value = std::move(values_.front());
+    values_.pop_front();
+    return value;
+}
+
+Object DequeObject::pop_back()
+{
+    check_not_empty();
+    Object value = std::move(values_.back());
+    values_.pop_back();
+    return value;
+}
+
+const Object& DequeObject::at(size_t index) const
+{
+    return values_.at(index);
+}
+
+bool DequeObject::eq(const DequeObject& deque) const
+{
+    if (this == &deque) {
+        return true;
+    }
+    return size() == deque.size() && std::equal(values_.begin(), values_.end(), deque.values_.begin(),
+        [](const Object& left, const Object& right) {
+            return left.equal(right);
+        });
+}
+
+void DequeObject::gc_visit(gc::Visitor& visitor)
+{
+    for (auto& value: values_) {
+        value.gc_visit(visitor);
+    }
+}
+
+BaseObject* DequeObject::move_to(void* slot)
+{
+    return ::new (slot) DequeObject(std::move(*this));
+}
+
+size_t DequeObject::external_size() const
+{
+    // Elements are allocated by chunks, ignored: estimate
+    return values_.size() * sizeof(Object);
+}
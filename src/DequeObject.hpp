@@ -0,0 +1,62 @@
+#ifndef ASPIC_DEQUE_OBJECT_HPP
+#define ASPIC_DEQUE_OBJECT_HPP
+
+#include "BaseObject.hpp"
+#include "Object.hpp"
+
+#include <deque>
+
+/**
+ * A double-ended queue of Object: push and pop at both ends in O(1)
+ */
+class DequeObject: public BaseObject
+{
+public:
+    DequeObject();
+    ~DequeObject();
+
+    const char* class_name() const override;
+
+    size_t size() const;
+
+    void push_front(const Object& object);
+    void push_back(const Object& object);
+
+    /**
+     * Remove and return value at one end
+     * Throw ValueError if deque is empty
+     */
+    Object pop_front();
+    Object pop_back();
+
+    /**
+     * Get value at given index (0 is the front)
+     */
+    const Object& at(size_t index) const;
+
+    /**
+     * Compare two deques
+     */
+    bool eq(const DequeObject& deque) const;
+
+    void gc_visit(gc::Visitor& visitor) override;
+
+    BaseObject* move_to(void* slot) override;
+
+    size_t external_size() const override;
+
+private:
+    DequeObject(const DequeObject&) = delete;
+    DequeObject& operator=(const DequeObject&) = delete;
+
+    DequeObject(DequeObject&& deque);
+
+    /**
+     * Throw ValueError if deque is empty
+     */
+    void check_not_empty() const;
+
+    std::deque<Object> values_;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#include "Hash.hpp"
+
+#include <cstring>
+#include <random>
+
+namespace {
+
+const uint64_t P0 = 0xa0761d6478bd642full;
+const uint64_t P1 = 0xe7037ed1a0b428dbull;
+const uint64_t P2 = 0x8ebc6af09c88c6e3ull;
+const uint64_t P3 = 0x589965cc75374cc3ull;
+
+inline uint64_t read64(const uint8_t* p)
+{
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint64_t read32(const uint8_t* p)
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// Read 1 to 3 bytes
+inline uint64_t read_small(const uint8_t* p, size_t length)
+{
+    return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[length >> 1]) << 8) | p[length - 1];
+}
+
+uint64_t random_seed()
+{
+    std::random_device device;
+    uint64_t seed = (static_cast<uint64_t>(device()) << 32) | device();
+    return Hash::mix(seed ^ P0, P1);
+}
+
+}
+
+// Init static attributes
+uint64_t Hash::seed_ = random_seed();
+
+
+uint64_t Hash::bytes(const void* data, size_t length)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint64_t seed = seed_;
+    uint64_t a;
+    uint64_t b;
+    if (length <= 16) {
+        if (length >= 4) {
+            // Two overlapping reads of 8 bytes, from both ends
+            size_t middle = (length >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + middle);
+            b = (read32(p + length - 4) << 32) | read32(p + length - 4 - middle);
+        }
+        else if (length > 0) {
+            a = read_small(p, length);
+            b = 0;
+        }
+        else {
+            a = b = 0;
+        }
+    }
+    else {
+        size_t remaining = length;
+        if (remaining > 48) {
+            // Three independent lanes
+            uint64_t seed1 = seed;
+            uint64_t seed2 = seed;
+            do {
+                seed = mix(read64(p) ^ P1, read64(p + 8) ^ seed);
+                seed1 = mix(read64(p + 16) ^ P2, read64(p + 24) ^ seed1);
+                seed2 = mix(read64(p + 32) ^ P3, read64(p + 40) ^ seed2);
+                p += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (remaining > 16) {
+            seed = mix(read64(p) ^ P1, read64(p + 8) ^ seed);
+            p += 16;
+            remaining -= 16;
+        }
+        // Last 16 bytes, which may overlap the previous block
+        a = read64(p + remaining - 16);
+        b = read64(p + remaining - 8);
+    }
+    return mix(P1 ^ length, mix(a ^ P1, b ^ seed));
+}
@@ -0,0 +1,68 @@
+#ifndef ASPIC_HASH_HPP
+#define ASPIC_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Hash functions for hashmap keys, based on wyhash.
+ *
+ * All functions mix a seed drawn at random when the process starts, so
+ * that keys colliding in the index can't be crafted in advance.
+ */
+class Hash
+{
+public:
+    /**
+     * Hash a sequence of bytes
+     */
+    static uint64_t bytes(const void* data, size_t length);
+
+    /**
+     * Hash an integer
+     */
+    static inline uint64_t integer(uint64_t value)
+    {
+        return mix(value ^ seed_, 0xe7037ed1a0b428dbull);
+    }
+
+    /**
+     * Multiply two integers, and fold the 128 bits result
+     */
+    static inline uint64_t mix(uint64_t a, uint64_t b)
+    {
+        __extension__ typedef unsigned __int128 uint128;
+        uint128 product = static_cast<uint128>(a) * b;
+        return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+    }
+
+    /**
+     * Spread a hash so that every output bit depends on every input bit
+     * (murmur3 finalizer). Hashes of close integers share most of their high
+     * bits, which is fine for the hashmap index but biases sketches.
+     */
+    static inline uint64_t scramble(uint64_t hash)
+    {
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ull;
+        return hash ^ (hash >> 33);
+    }
+
+    /**
+     * Map a hash to [0, n), using its high bits (faster than a modulo)
+     */
+    static inline uint64_t reduce(uint64_t hash, uint64_t n)
+    {
+        __extension__ typedef unsigned __int128 uint128;
+        return static_cast<uint64_t>((static_cast<uint128>(hash) * n) >> 64);
+    }
+
+private:
+    Hash() = delete;
+
+    static uint64_t seed_;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#include "HashIndex.hpp"
+
+// Init static attributes
+const size_t HashIndex::NOT_FOUND;
+const size_t HashIndex::GROUP_SIZE;
+const int8_t HashIndex::EMPTY;
+const int8_t HashIndex::DELETED;
+
+
+bool HashIndex::full(size_t count) const
+{
+    // Keep load factor, deleted slots included, under 7/8
+    return (count + deleted_ + 1) * 8 > control_.size() * 7;
+}
+
+void HashIndex::reset(size_t count)
+{
+    size_t capacity = GROUP_SIZE;
+    while (capacity * 7 < count * 16) {
+        capacity *= 2;
+    }
+    control_.assign(capacity, EMPTY);
+    slots_.resize(capacity);
+    deleted_ = 0;
+}
+
+void HashIndex::insert(size_t hash, uint32_t position)
+{
+    size_t group_mask = control_.size() / GROUP_SIZE - 1;
+    size_t group = first_group(hash, group_mask);
+    for (size_t step = 1; ; ++step) {
+        uint32_t free_slots = match_free(&control_[group * GROUP_SIZE]);
+        if (free_slots != 0) {
+            size_t slot = group * GROUP_SIZE + __builtin_ctz(free_slots);
+            if (control_[slot] == DELETED) {
+                --deleted_;
+            }
+            control_[slot] = control_byte(hash);
+            slots_[slot] = position;
+            return;
+        }
+        group = (group + step) & group_mask;
+    }
+}
+
+size_t HashIndex::find_slot(size_t hash, uint32_t position) const
+{
+    size_t group_mask = control_.size() / GROUP_SIZE - 1;
+    int8_t control = control_byte(hash);
+    size_t group = first_group(hash, group_mask);
+    for (size_t step = 1; ; ++step) {
+        for (uint32_t match = match_group(&control_[group * GROUP_SIZE], control); match != 0; match &= match - 1) {
+            size_t slot = group * GROUP_SIZE + __builtin_ctz(match);
+            if (slots_[slot] == position) {
+                return slot;
+            }
+        }
+        group = (group + step) & group_mask;
+    }
+}
+
+void HashIndex::erase(size_t hash, uint32_t position)
+{
+    // Deleted slots keep probe sequences going: they're only reused, or cleared on rebuild
+    control_[find_slot(hash, position)] = DELETED;
+    ++deleted_;
+}
+
+void HashIndex::move(size_t hash, uint32_t from, uint32_t to)
+{
+    slots_[find_slot(hash, from)] = to;
+}
+
+size_t HashIndex::memory() const
+{
+    return control_.capacity() * sizeof(int8_t) + slots_.capacity() * sizeof(uint32_t);
+}
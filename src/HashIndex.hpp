@@ -0,0 +1,162 @@
+#ifndef ASPIC_HASH_INDEX_HPP
+#define ASPIC_HASH_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define ASPIC_X86_SIMD
+#include <emmintrin.h>
+#endif
+
+/**
+ * Open addressing index mapping hashes to positions in a vector of entries,
+ * stored by the container (Swiss table layout).
+ *
+ * Slots are probed by groups of 16, comparing 7 bits of the hash stored in
+ * a control byte per slot, with SSE2 if available. The index doesn't store
+ * full hashes nor keys: callers provide them to match and rebuild entries.
+ */
+class HashIndex
+{
+public:
+    static const size_t NOT_FOUND = SIZE_MAX;
+
+    /**
+     * Find an entry position with given hash, for which matches(position) is true
+     * @return position, or NOT_FOUND
+     */
+    template<typename Predicate>
+    size_t find(size_t hash, Predicate matches) const
+    {
+        if (control_.empty()) {
+            return NOT_FOUND;
+        }
+        // Triangular probing visits every group, as the group count is a power of 2
+        size_t group_mask = control_.size() / GROUP_SIZE - 1;
+        int8_t control = control_byte(hash);
+        size_t group = first_group(hash, group_mask);
+        for (size_t step = 1; ; ++step) {
+            const int8_t* group_control = &control_[group * GROUP_SIZE];
+            for (uint32_t match = match_group(group_control, control); match != 0; match &= match - 1) {
+                uint32_t position = slots_[group * GROUP_SIZE + __builtin_ctz(match)];
+                if (matches(position)) {
+                    return position;
+                }
+            }
+            // The index is never full: probing stops at the first group with an empty slot
+            if (match_group(group_control, EMPTY) != 0) {
+                return NOT_FOUND;
+            }
+            group = (group + step) & group_mask;
+        }
+    }
+
+    /**
+     * Check if the index must be rebuilt before adding an entry
+     */
+    bool full(size_t count) const;
+
+    /**
+     * Add an entry position (the index must not be full)
+     */
+    void insert(size_t hash, uint32_t position);
+
+    /**
+     * Remove an entry position
+     */
+    void erase(size_t hash, uint32_t position);
+
+    /**
+     * Replace position of an entry, moved in the entries vector
+     */
+    void move(size_t hash, uint32_t from, uint32_t to);
+
+    /**
+     * Resize the index for count entries and some room, then add positions
+     * [0, count), hash_of(position) returns the hash of an entry
+     */
+    template<typename HashOf>
+    void rebuild(size_t count, HashOf hash_of)
+    {
+        reset(count);
+        for (size_t i = 0; i < count; ++i) {
+            insert(hash_of(i), i);
+        }
+    }
+
+    /**
+     * Get allocated bytes
+     */
+    size_t memory() const;
+
+private:
+    static const size_t GROUP_SIZE = 16;
+    static const int8_t EMPTY = -128;
+    static const int8_t DELETED = -2;
+
+    /**
+     * Clear the index, with enough slots for twice count entries
+     */
+    void reset(size_t count);
+
+    /**
+     * Find slot holding given entry position
+     */
+    size_t find_slot(size_t hash, uint32_t position) const;
+
+    /**
+     * Get bit mask of control bytes equal to value in a group
+     */
+    static inline uint32_t match_group(const int8_t* group, int8_t value)
+    {
+#ifdef ASPIC_X86_SIMD
+        __m128i control = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(value)));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP_SIZE; ++i) {
+            if (group[i] == value) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+#endif
+    }
+
+    /**
+     * Get bit mask of empty or deleted slots in a group (negative control bytes)
+     */
+    static inline uint32_t match_free(const int8_t* group)
+    {
+#ifdef ASPIC_X86_SIMD
+        return _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group)));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP_SIZE; ++i) {
+            if (group[i] < 0) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+#endif
+    }
+
+    // Low bits of the hash are stored in control bytes, high bits select the first group
+    static inline int8_t control_byte(size_t hash)
+    {
+        return hash & 0x7f;
+    }
+
+    static inline size_t first_group(size_t hash, size_t group_mask)
+    {
+        return (hash >> 7) & group_mask;
+    }
+
+    std::vector<int8_t> control_;  // EMPTY, DELETED, or low 7 bits of the slot hash
+    std::vector<uint32_t> slots_;  // entry position, if control byte is a hash
+    size_t deleted_ = 0;
+};
+
+#endif
@@ -1,15 +1,51 @@
 #include "HashObject.hpp"
 #include "ArrayObject.hpp"
 #include "Error.hpp"
+#include "Shape.hpp"
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <new>
 
 HashObject::HashObject():
-    BaseObject()
+    BaseObject(),
+    layout_(DIRECT),
+    shape_(nullptr)
 {
+    storage_.table = nullptr;
+}
+
+HashObject::HashObject(HashObject&& hash):
+    BaseObject(hash),
+    layout_(hash.layout_),
+    shape_(hash.shape_)
+{
+    if (layout_ == SHAPED) {
+        ::new (&storage_.values) std::vector<Object>(std::move(hash.storage_.values));
+    }
+    else {
+        storage_.table = hash.storage_.table;
+        hash.storage_.table = nullptr;
+    }
 }
 
 HashObject::~HashObject()
 {
+    if (layout_ == SHAPED) {
+        storage_.values.~vector();
+    }
+    else {
+        delete storage_.table;
+    }
+}
+
+HashObject::Table& HashObject::table()
+{
+    if (storage_.table == nullptr) {
+        storage_.table = new Table();
+    }
+    return *storage_.table;
 }
 
 const char* HashObject::class_name() const
@@ -19,7 +55,25 @@ const char* HashObject::class_name() const
 
 size_t HashObject::size() const
 {
-    return values_.size();
+    if (layout_ == SHAPED) {
+        return storage_.values.size();
+    }
+    return storage_.table != nullptr ? storage_.table->entries.size() : 0;
+}
+
+const Object& HashObject::key_at(size_t position) const
+{
+    return layout_ == SHAPED ? shape_->key_at(position) : storage_.table->entries[position].key;
+}
+
+const Object& HashObject::value_at(size_t position) const
+{
+    return layout_ == SHAPED ? storage_.values[position] : storage_.table->entries[position].value;
+}
+
+Object& HashObject::value_at(size_t position)
+{
+    return layout_ == SHAPED ? storage_.values[position] : storage_.table->entries[position].value;
 }
 
 bool HashObject::eq(const HashObject& hash) const
@@ -30,37 +84,222 @@ bool HashObject::eq(const HashObject& hash) const
     if (size() != hash.size()) {
         return false;
     }
-    return this->values_ == hash.values_;
+    for (size_t i = 0; i < size(); ++i) {
+        size_t position = hash.find(key_at(i));
+        if (position == NOT_FOUND || !(hash.value_at(position) == value_at(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool HashObject::direct_slot(const Object& key, size_t& slot)
+{
+    if (key.get_type() == Object::INT) {
+        int value = key.get_int();
+        slot = value;
+        return value >= 0;
+    }
+    if (key.get_type() == Object::FLOAT) {
+        // Integral floats are equal to int keys
+        double value = key.get_float();
+        if (value >= 0 && value <= INT_MAX && value == std::trunc(value)) {
+            slot = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t HashObject::find(const Object& key) const
+{
+    switch (layout_) {
+        case DIRECT:
+        {
+            size_t slot;
+            const Table* table = storage_.table;
+            if (table != nullptr && direct_slot(key, slot)
+                && slot < table->direct_index.size() && table->direct_index[slot] != 0) {
+                return table->direct_index[slot] - 1;
+            }
+            return NOT_FOUND;
+        }
+        case SHAPED:
+            return key.get_type() == Object::STRING ? shape_->find(key) : NOT_FOUND;
+        case HASHED:
+            break;
+    }
+    return find(key, std::hash<Object>{}(key));
+}
+
+size_t HashObject::find(const Object& key, size_t hash) const
+{
+    const Table& table = *storage_.table;
+    return table.index.find(hash, [&](uint32_t position) {
+        const Entry& entry = table.entries[position];
+        return entry.hash == hash && entry.key == key;
+    });
+}
+
+void HashObject::switch_to_hash_index()
+{
+    if (layout_ == SHAPED) {
+        Table* table = new Table();
+        std::vector<Object>& values = storage_.values;
+        table->entries.reserve(values.size() + 1);
+        for (size_t i = 0; i < values.size(); ++i) {
+            table->entries.push_back(Entry{shape_->key_at(i), std::move(values[i]), 0});
+        }
+        values.~vector();
+        storage_.table = table;
+        shape_ = nullptr;
+    }
+    Table& t = table();
+    std::vector<uint32_t>().swap(t.direct_index);
+    layout_ = HASHED;
+    for (Entry& entry: t.entries) {
+        entry.hash = std::hash<Object>{}(entry.key);
+    }
+    rebuild_index();
+}
+
+void HashObject::rebuild_index()
+{
+    Table& table = *storage_.table;
+    table.index.rebuild(table.entries.size(), [&table](size_t position) {
+        return table.entries[position].hash;
+    });
 }
 
 void HashObject::push(const Object& key, const Object& value)
 {
-    values_[key] = value;
+    // get_value() ensures identifier references are resolved, for hashing and storage
+    const Object& k = key.get_value();
+    if (layout_ == DIRECT && size() == 0 && k.get_type() == Object::STRING) {
+        delete storage_.table;
+        ::new (&storage_.values) std::vector<Object>();
+        layout_ = SHAPED;
+        shape_ = Shape::root();
+    }
+    if (layout_ == SHAPED) {
+        size_t offset = find(k);
+        if (offset != NOT_FOUND) {
+            storage_.values[offset] = value.get_value();
+            return;
+        }
+        Shape* shape = k.get_type() == Object::STRING ? shape_->add(k) : nullptr;
+        if (shape != nullptr) {
+            shape_ = shape;
+            storage_.values.push_back(value.get_value());
+            return;
+        }
+        switch_to_hash_index();
+    }
+    else if (layout_ == DIRECT) {
+        Table& t = table();
+        size_t slot;
+        if (direct_slot(k, slot)) {
+            if (slot < t.direct_index.size() && t.direct_index[slot] != 0) {
+                t.entries[t.direct_index[slot] - 1].value = value.get_value();
+                return;
+            }
+            // Entry hashes are only computed when switching to the hash index
+            if (k.get_type() == Object::INT
+                && slot < std::max(DIRECT_MIN_SPAN, (t.entries.size() + 1) * DIRECT_SPAN_FACTOR)) {
+                t.entries.push_back(Entry{k, value.get_value(), 0});
+                if (slot >= t.direct_index.size()) {
+                    t.direct_index.resize(slot + 1, 0);
+                }
+                t.direct_index[slot] = t.entries.size();
+                return;
+            }
+        }
+        switch_to_hash_index();
+    }
+    Table& t = *storage_.table;
+    size_t hash = std::hash<Object>{}(k);
+    size_t position = find(k, hash);
+    if (position != NOT_FOUND) {
+        t.entries[position].value = value.get_value();
+        return;
+    }
+    if (t.index.full(t.entries.size())) {
+        t.entries.push_back(Entry{k, value.get_value(), hash});
+        rebuild_index();
+    }
+    else {
+        t.entries.push_back(Entry{k, value.get_value(), hash});
+        t.index.insert(hash, t.entries.size() - 1);
+    }
 }
 
 Object& HashObject::at(const Object& key)
 {
-    try {
-        return values_.at(key);
+    const Object& k = key.get_value();
+    size_t position = find(k);
+    if (position == NOT_FOUND) {
+        throw Error::KeyError(k.to_string());
     }
-    catch (const std::out_of_range& e) {
-        throw Error::KeyError(key.to_string());
+    return value_at(position);
+}
+
+Object& HashObject::at(const Object& key, LookupCache& cache)
+{
+    if (layout_ == SHAPED) {
+        if (shape_ != cache.shape) {
+            size_t offset = shape_->find(key);
+            if (offset == NOT_FOUND) {
+                throw Error::KeyError(key.to_string());
+            }
+            cache.shape = shape_;
+            cache.offset = offset;
+        }
+        return storage_.values[cache.offset];
     }
+    return at(key);
 }
 
 ArrayObject* HashObject::get_keys() const
 {
-    ArrayObject* array = new ArrayObject(values_.size());
-    for (InternalHash::const_iterator it = values_.begin(); it != values_.end(); ++it) {
-        array->push(it->first);
+    ArrayObject* array = new ArrayObject(size());
+    for (size_t i = 0; i < size(); ++i) {
+        array->push(key_at(i));
     }
     return array;
 }
 
-void HashObject::gc_visit()
+BaseObject* HashObject::move_to(void* slot)
 {
-    for (InternalHash::const_iterator it = values_.begin(); it != values_.end(); ++it) {
-        it->first.gc_visit();
-        it->second.gc_visit();
+    return ::new (slot) HashObject(std::move(*this));
+}
+
+size_t HashObject::external_size() const
+{
+    if (layout_ == SHAPED) {
+        return storage_.values.capacity() * sizeof(Object);
+    }
+    const Table* table = storage_.table;
+    if (table == nullptr) {
+        return 0;
+    }
+    return sizeof(Table)
+        + table->entries.capacity() * sizeof(Entry)
+        + table->direct_index.capacity() * sizeof(uint32_t)
+        + table->index.memory();
+}
+
+void HashObject::gc_visit(gc::Visitor& visitor)
+{
+    if (layout_ == SHAPED) {
+        for (Object& value: storage_.values) {
+            value.gc_visit(visitor);
+        }
+    }
+    else if (storage_.table != nullptr) {
+        // Keys may be frozen arrays
+        for (Entry& entry: storage_.table->entries) {
+            entry.key.gc_visit(visitor);
+            entry.value.gc_visit(visitor);
+        }
     }
 }
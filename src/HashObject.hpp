@@ -3,19 +3,49 @@
 
 #include "BaseObject.hpp"
 #include "Object.hpp"
+#include "HashIndex.hpp"
 
-#include <unordered_map>
+#include <cstdint>
+#include <vector>
 
 class ArrayObject;
+class Shape;
 
 /**
  * A hashmap of 'Object', for both keys and values
- * Implemented as a wrapper around std::unordered_map
+ *
+ * Key-value pairs are stored in insertion order in a dense vector of
+ * entries. A separate open addressing index (see HashIndex) maps hashes
+ * to entry positions.
+ *
+ * While all keys are non-negative ints in a compact range, the index is a
+ * plain vector of positions instead, indexed by key: a lookup is a bounds
+ * check and a load. While all keys are strings, and the map holds few of
+ * them, keys are stored in a Shape shared with maps having the same keys,
+ * and only values are stored in the map. The first key which doesn't fit
+ * the layout switches the map to the hash index.
+ *
+ * Entries and indexes are allocated outside of the object, so a shaped map
+ * (a record) only holds its shape and a vector of values.
  */
 class HashObject: public BaseObject
 {
 public:
-    typedef std::unordered_map<Object, Object> InternalHash;
+    struct Entry
+    {
+        Object key;
+        Object value;
+        size_t hash;
+    };
+
+    /**
+     * Cache for lookups with a constant key, of shaped maps
+     */
+    struct LookupCache
+    {
+        const Shape* shape = nullptr;
+        size_t offset = 0;
+    };
 
     HashObject();
     ~HashObject();
@@ -39,29 +69,109 @@ public:
 
     /**
      * Get value at given index
+     * The reference is invalidated when a key is added.
      */
     Object& at(const Object& key);
 
     /**
-     * Get list of keys
+     * Get value at given string key, cache the key offset if the map is shaped
+     */
+    Object& at(const Object& key, LookupCache& cache);
+
+    /**
+     * Get list of keys, in insertion order
      */
     ArrayObject* get_keys() const;
 
-    InternalHash::const_iterator begin() {
-        return values_.begin();
-    }
+    /**
+     * Get key or value at given position, in insertion order
+     */
+    const Object& key_at(size_t position) const;
+    const Object& value_at(size_t position) const;
+    Object& value_at(size_t position);
+
+    void gc_visit(gc::Visitor& visitor) override;
+
+    BaseObject* move_to(void* slot) override;
 
-    InternalHash::const_iterator end() {
-        return values_.end();
-    }
+    size_t external_size() const override;
 
 private:
     HashObject(const HashObject&) = delete;
     HashObject& operator=(const HashObject&) = delete;
 
-    void gc_visit();
+    HashObject(HashObject&& hash);
+
+    /**
+     * Key layout, see class description
+     */
+    enum Layout
+    {
+        DIRECT, // table direct_index and entries
+        SHAPED, // shape_ and storage values
+        HASHED  // table index and entries
+    };
+
+    /**
+     * Get position of key, or NOT_FOUND
+     */
+    size_t find(const Object& key) const;
+
+    /**
+     * Get position of key in table entries using the hash index, or NOT_FOUND
+     */
+    size_t find(const Object& key, size_t hash) const;
+
+    /**
+     * Get slot of a key in the direct index, if key is a non-negative
+     * integral number
+     */
+    static bool direct_slot(const Object& key, size_t& slot);
+
+    /**
+     * Build the hash index, and switch to the HASHED layout
+     */
+    void switch_to_hash_index();
+
+    /**
+     * Resize the hash index for table entries, and fill it again
+     */
+    void rebuild_index();
+
+    static const size_t NOT_FOUND = HashIndex::NOT_FOUND;
+
+    // Direct index spans at most DIRECT_SPAN_FACTOR slots per key, or DIRECT_MIN_SPAN slots
+    static const size_t DIRECT_SPAN_FACTOR = 4;
+    static const size_t DIRECT_MIN_SPAN = 64;
+
+    /**
+     * Entries and their index, for the DIRECT and HASHED layouts
+     */
+    struct Table
+    {
+        std::vector<Entry> entries;
+        std::vector<uint32_t> direct_index; // DIRECT: position in entries + 1 by key, 0 if none
+        HashIndex index;                    // HASHED
+    };
+
+    /**
+     * Get table, allocated when the first entry is added
+     */
+    Table& table();
+
+    // Only the member matching layout_ is constructed
+    union Storage
+    {
+        Storage() {}
+        ~Storage() {}
+
+        std::vector<Object> values; // SHAPED: values at the offset of their key in shape_
+        Table* table;               // DIRECT, HASHED: nullptr while the map is empty
+    };
 
-    InternalHash values_;
+    Layout layout_;
+    Shape* shape_; // SHAPED only
+    Storage storage_;
 };
 
 #endif
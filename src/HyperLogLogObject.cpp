@@ -0,0 +1,105 @@
+#include "HyperLogLogObject.hpp"
+#include "Object.hpp"
+#include "Error.hpp"
+#include "Hash.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <new>
+
+// Init static attributes
+const int HyperLogLogObject::MIN_PRECISION;
+const int HyperLogLogObject::MAX_PRECISION;
+
+
+HyperLogLogObject::HyperLogLogObject(int precision):
+    BaseObject(),
+    registers_(size_t(1) << precision, 0),
+    precision_(precision)
+{
+}
+
+HyperLogLogObject::HyperLogLogObject(HyperLogLogObject&& sketch):
+    BaseObject(sketch),
+    registers_(std::move(sketch.registers_)),
+    precision_(sketch.precision_)
+{
+}
+
+HyperLogLogObject::~HyperLogLogObject()
+{
+}
+
+const char* HyperLogLogObject::class_name() const
+{
+    return "hll";
+}
+
+int HyperLogLogObject::precision() const
+{
+    return precision_;
+}
+
+void HyperLogLogObject::add(const Object& value)
+{
+    uint64_t hash = Hash::scramble(std::hash<Object>{}(value.get_value()));
+    size_t index = hash >> (64 - precision_);
+    // A sentinel bit bounds the rank when the remaining bits are all 0
+    uint64_t remaining = (hash << precision_) | (uint64_t(1) << (precision_ - 1));
+    uint8_t rank = __builtin_clzll(remaining) + 1;
+    if (rank > registers_[index]) {
+        registers_[index] = rank;
+    }
+}
+
+double HyperLogLogObject::count() const
+{
+    double m = registers_.size();
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t rank: registers_) {
+        sum += std::ldexp(1.0, -rank);
+        zeros += rank == 0;
+    }
+    double alpha = precision_ == 4 ? 0.673 : precision_ == 5 ? 0.697 : precision_ == 6 ? 0.709
+        : 0.7213 / (1 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+    // Linear counting is more accurate for small cardinalities. Hashes are
+    // 64 bits, so no correction is needed for large ones.
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / zeros);
+    }
+    return estimate;
+}
+
+bool HyperLogLogObject::eq(const HyperLogLogObject& sketch) const
+{
+    return registers_ == sketch.registers_;
+}
+
+HyperLogLogObject* HyperLogLogObject::merge(const HyperLogLogObject& a, const HyperLogLogObject& b)
+{
+    if (a.precision_ != b.precision_) {
+        throw Error::ValueError("hll sketches must have the same precision");
+    }
+    HyperLogLogObject* sketch = new HyperLogLogObject(a.precision_);
+    for (size_t i = 0; i < sketch->registers_.size(); ++i) {
+        sketch->registers_[i] = std::max(a.registers_[i], b.registers_[i]);
+    }
+    return sketch;
+}
+
+BaseObject* HyperLogLogObject::move_to(void* slot)
+{
+    return ::new (slot) HyperLogLogObject(std::move(*this));
+}
+
+size_t HyperLogLogObject::external_size() const
+{
+    return registers_.capacity();
+}
+
+void HyperLogLogObject::gc_visit(gc::Visitor&)
+{
+    // Values are only hashed, never stored
+}
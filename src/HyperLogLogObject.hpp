@@ -0,0 +1,69 @@
+#ifndef ASPIC_HYPERLOGLOG_OBJECT_HPP
+#define ASPIC_HYPERLOGLOG_OBJECT_HPP
+
+#include "BaseObject.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class Object;
+
+/**
+ * A HyperLogLog sketch: approximate count of distinct hashable values, in
+ * fixed memory
+ *
+ * The first precision bits of a value's Object hash select one of
+ * 2^precision registers, which keeps the longest run of leading zeros seen
+ * in the remaining bits. The standard error is 1.04 / sqrt(2^precision).
+ */
+class HyperLogLogObject: public BaseObject
+{
+public:
+    static const int MIN_PRECISION = 4;
+    static const int MAX_PRECISION = 18;
+
+    explicit HyperLogLogObject(int precision);
+    ~HyperLogLogObject();
+
+    const char* class_name() const override;
+
+    int precision() const;
+
+    /**
+     * Add a value
+     */
+    void add(const Object& value);
+
+    /**
+     * Estimate the number of distinct values added
+     */
+    double count() const;
+
+    /**
+     * Compare two sketches
+     */
+    bool eq(const HyperLogLogObject& sketch) const;
+
+    /**
+     * Create a sketch counting values of both sketches
+     * Throw ValueError if sketches have different precisions
+     */
+    static HyperLogLogObject* merge(const HyperLogLogObject& a, const HyperLogLogObject& b);
+
+    void gc_visit(gc::Visitor& visitor) override;
+
+    BaseObject* move_to(void* slot) override;
+
+    size_t external_size() const override;
+
+private:
+    HyperLogLogObject(const HyperLogLogObject&) = delete;
+    HyperLogLogObject& operator=(const HyperLogLogObject&) = delete;
+
+    HyperLogLogObject(HyperLogLogObject&& sketch);
+
+    std::vector<uint8_t> registers_;
+    int precision_;
+};
+
+#endif
@@ -0,0 +1,280 @@
+#include "LruObject.hpp"
+#include "gc/Heap.hpp"
+
+#include <new>
+
+// Init static attributes
+const uint32_t LruObject::NONE;
+
+
+LruObject::LruObject(size_t capacity, bool in_bytes):
+    BaseObject(),
+    head_(NONE),
+    tail_(NONE),
+    capacity_(capacity),
+    in_bytes_(in_bytes),
+    bytes_(0),
+    hits_(0),
+    misses_(0),
+    evictions_(0)
+{
+}
+
+LruObject::LruObject(LruObject&& lru):
+    BaseObject(lru),
+    entries_(std::move(lru.entries_)),
+    index_(std::move(lru.index_)),
+    head_(lru.head_),
+    tail_(lru.tail_),
+    capacity_(lru.capacity_),
+    in_bytes_(lru.in_bytes_),
+    bytes_(lru.bytes_),
+    hits_(lru.hits_),
+    misses_(lru.misses_),
+    evictions_(lru.evictions_)
+{
+}
+
+LruObject::~LruObject()
+{
+}
+
+const char* LruObject::class_name() const
+{
+    return "lru";
+}
+
+size_t LruObject::size() const
+{
+    return entries_.size();
+}
+
+size_t LruObject::find(const Object& key, size_t hash) const
+{
+    return index_.find(hash, [&](uint32_t position) {
+        const Entry& entry = entries_[position];
+        return entry.hash == hash && entry.key == key;
+    });
+}
+
+void LruObject::link_front(uint32_t position)
+{
+    Entry& entry = entries_[position];
+    entry.prev = NONE;
+    entry.next = head_;
+    if (head_ != NONE) {
+        entries_[head_].prev = position;
+    }
+    else {
+        tail_ = position;
+    }
+    head_ = position;
+}
+
+void LruObject::unlink(uint32_t position)
+{
+    Entry& entry = entries_[position];
+    if (entry.prev != NONE) {
+        entries_[entry.prev].next = entry.next;
+    }
+    else {
+        head_ = entry.next;
+    }
+    if (entry.next != NONE) {
+        entries_[entry.next].prev = entry.prev;
+    }
+    else {
+        tail_ = entry.prev;
+    }
+}
+
+void LruObject::erase(uint32_t position)
+{
+    unlink(position);
+    index_.erase(entries_[position].hash, position);
+    bytes_ -= entries_[position].bytes;
+    // Fill the hole with the last entry, and fix links to it
+    uint32_t last = entries_.size() - 1;
+    if (position != last) {
+        Entry& moved = entries_[position];
+        moved = std::move(entries_[last]);
+        index_.move(moved.hash, last, position);
+        if (moved.prev != NONE) {
+            entries_[moved.prev].next = position;
+        }
+        else {
+            head_ = position;
+        }
+        if (moved.next != NONE) {
+            entries_[moved.next].prev = position;
+        }
+        else {
+            tail_ = position;
+        }
+    }
+    entries_.pop_back();
+}
+
+size_t LruObject::entry_bytes(const Object& key, const Object& value)
+{
+    size_t bytes = sizeof(Entry);
+    for (const Object* object: {&key, &value}) {
+        if (object->get_type() == Object::STRING) {
+            bytes += object->get_string().size();
+        }
+        else if (const BaseObject* shared = object->get_shared_object()) {
+            bytes += gc::Heap::slot_size(shared) + shared->external_size();
+        }
+    }
+    return bytes;
+}
+
+bool LruObject::over_capacity() const
+{
+    return (in_bytes_ ? bytes_ : entries_.size()) > capacity_;
+}
+
+const Object* LruObject::get(const Object& key)
+{
+    const Object& k = key.get_value();
+    size_t position = find(k, std::hash<Object>{}(k));
+    if (position == HashIndex::NOT_FOUND) {
+        ++misses_;
+        return nullptr;
+    }
+    ++hits_;
+    if (position != head_) {
+        unlink(position);
+        link_front(position);
+    }
+    return &entries_[position].value;
+}
+
+bool LruObject::contains(const Object& key) const
+{
+    const Object& k = key.get_value();
+    return find(k, std::hash<Object>{}(k)) != HashIndex::NOT_FOUND;
+}
+
+void LruObject::put(const Object& key, const Object& value)
+{
+    // get_value() ensures identifier references are resolved, for hashing and storage
+    const Object& k = key.get_value();
+    const Object& v = value.get_value();
+    size_t hash = std::hash<Object>{}(k);
+    size_t bytes = entry_bytes(k, v);
+    size_t position = find(k, hash);
+    if (in_bytes_ && bytes > capacity_) {
+        if (position != HashIndex::NOT_FOUND) {
+            erase(position);
+        }
+        ++evictions_;
+        return;
+    }
+    if (position != HashIndex::NOT_FOUND) {
+        Entry& entry = entries_[position];
+        entry.value = v;
+        bytes_ += bytes - entry.bytes;
+        entry.bytes = bytes;
+        if (position != head_) {
+            unlink(position);
+            link_front(position);
+        }
+    }
+    else {
+        entries_.push_back(Entry{k, v, hash, bytes, NONE, NONE});
+        bytes_ += bytes;
+        position = entries_.size() - 1;
+        if (index_.full(position)) {
+            index_.rebuild(entries_.size(), [this](size_t i) {
+                return entries_[i].hash;
+            });
+        }
+        else {
+            index_.insert(hash, position);
+        }
+        link_front(position);
+    }
+
+    // The entry just put fits alone, so it is never evicted
+    while (over_capacity()) {
+        erase(tail_);
+        ++evictions_;
+    }
+}
+
+bool LruObject::remove(const Object& key)
+{
+    const Object& k = key.get_value();
+    size_t position = find(k, std::hash<Object>{}(k));
+    if (position == HashIndex::NOT_FOUND) {
+        return false;
+    }
+    erase(position);
+    return true;
+}
+
+bool LruObject::eq(const LruObject& lru) const
+{
+    if (this == &lru) {
+        return true;
+    }
+    if (size() != lru.size()) {
+        return false;
+    }
+    for (const Entry& entry: entries_) {
+        size_t position = lru.find(entry.key, entry.hash);
+        if (position == HashIndex::NOT_FOUND || !(lru.entries_[position].value == entry.value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t LruObject::capacity() const
+{
+    return capacity_;
+}
+
+bool LruObject::in_bytes() const
+{
+    return in_bytes_;
+}
+
+size_t LruObject::bytes() const
+{
+    return bytes_;
+}
+
+size_t LruObject::hits() const
+{
+    return hits_;
+}
+
+size_t LruObject::misses() const
+{
+    return misses_;
+}
+
+size_t LruObject::evictions() const
+{
+    return evictions_;
+}
+
+BaseObject* LruObject::move_to(void* slot)
+{
+    return ::new (slot) LruObject(std::move(*this));
+}
+
+size_t LruObject::external_size() const
+{
+    return entries_.capacity() * sizeof(Entry) + index_.memory();
+}
+
+void LruObject::gc_visit(gc::Visitor& visitor)
+{
+    for (Entry& entry: entries_) {
+        entry.key.gc_visit(visitor);
+        entry.value.gc_visit(visitor);
+    }
+}
@@ -0,0 +1,147 @@
+#ifndef ASPIC_LRU_OBJECT_HPP
+#define ASPIC_LRU_OBJECT_HPP
+
+#include "BaseObject.hpp"
+#include "Object.hpp"
+#include "HashIndex.hpp"
+
+#include <vector>
+
+/**
+ * A bounded map of hashable keys, evicting the least recently used entries
+ *
+ * Entries are stored in a dense vector indexed by a HashIndex, like in
+ * SetObject, and linked in a list from the most to the least recently used.
+ * Lookup, insertion and eviction are O(1).
+ *
+ * Capacity is either a number of entries, or an approximate number of bytes:
+ * the entry itself, string contents, and the memory of shared objects at
+ * insertion time (nested objects aren't counted).
+ */
+class LruObject: public BaseObject
+{
+public:
+    /**
+     * @param capacity: maximum number of entries, or of bytes
+     * @param in_bytes: capacity is in bytes
+     */
+    LruObject(size_t capacity, bool in_bytes);
+    ~LruObject();
+
+    const char* class_name() const override;
+
+    /**
+     * Get number of entries
+     */
+    size_t size() const;
+
+    /**
+     * Get value associated to key and mark the entry as most recently used,
+     * counting a hit, or a miss if there is no such key
+     * @return value, or nullptr
+     */
+    const Object* get(const Object& key);
+
+    /**
+     * Check if key exists, without updating order nor counters
+     */
+    bool contains(const Object& key) const;
+
+    /**
+     * Insert or replace an entry as most recently used, then evict least
+     * recently used entries over capacity. An entry larger than the byte
+     * capacity is not stored (a previous entry for its key is removed), and
+     * counts as an eviction.
+     */
+    void put(const Object& key, const Object& value);
+
+    /**
+     * Remove an entry
+     * @return false if key wasn't found
+     */
+    bool remove(const Object& key);
+
+    /**
+     * Compare entries of two caches, regardless of their order
+     */
+    bool eq(const LruObject& lru) const;
+
+    // Counters
+    size_t capacity() const;
+    bool in_bytes() const;
+    size_t bytes() const;
+    size_t hits() const;
+    size_t misses() const;
+    size_t evictions() const;
+
+    /**
+     * Call fn(key, value) for each entry, from the most recently used
+     */
+    template<typename Function>
+    void for_each(Function fn) const
+    {
+        for (uint32_t i = head_; i != NONE; i = entries_[i].next) {
+            fn(entries_[i].key, entries_[i].value);
+        }
+    }
+
+    void gc_visit(gc::Visitor& visitor) override;
+
+    BaseObject* move_to(void* slot) override;
+
+    size_t external_size() const override;
+
+private:
+    LruObject(const LruObject&) = delete;
+    LruObject& operator=(const LruObject&) = delete;
+
+    LruObject(LruObject&& lru);
+
+    static const uint32_t NONE = UINT32_MAX;
+
+    struct Entry
+    {
+        Object key;
+        Object value;
+        size_t hash;
+        size_t bytes;
+        uint32_t prev; // More recently used entry
+        uint32_t next; // Less recently used entry
+    };
+
+    /**
+     * Get position of key, or HashIndex::NOT_FOUND
+     */
+    size_t find(const Object& key, size_t hash) const;
+
+    /**
+     * Link/unlink an entry to the list, link_front makes it most recently used
+     */
+    void link_front(uint32_t position);
+    void unlink(uint32_t position);
+
+    /**
+     * Remove entry at position, moving the last entry in its place
+     */
+    void erase(uint32_t position);
+
+    /**
+     * Approximate memory used by an entry
+     */
+    static size_t entry_bytes(const Object& key, const Object& value);
+
+    bool over_capacity() const;
+
+    std::vector<Entry> entries_;
+    HashIndex index_;
+    uint32_t head_;
+    uint32_t tail_;
+    size_t capacity_;
+    bool in_bytes_;
+    size_t bytes_;
+    size_t hits_;
+    size_t misses_;
+    size_t evictions_;
+};
+
+#endif
@@ -7,20 +7,63 @@
 #include "Shell.hpp"
 #include "FileLoader.hpp"
 #include "SymbolTable.hpp"
+#include "Metrics.hpp"
+#include "gc/Marker.hpp"
+#include "gc/Profiler.hpp"
+#include "gc/RefCount.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
 
 
 int main(int argc, char* argv[])
 {
+    const char* filename = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--gc-threads=", 13) == 0) {
+            gc::Marker::set_thread_count(std::atoi(argv[i] + 13));
+        }
+        else if (strcmp(argv[i], "--gc=refcount") == 0) {
+            gc::RefCount::enable();
+        }
+        else if (strcmp(argv[i], "--gc=tracing") == 0) {
+            gc::RefCount::disable();
+        }
+        else if (strcmp(argv[i], "--heap-profile") == 0) {
+            gc::Profiler::enable();
+        }
+        else if (strncmp(argv[i], "--metrics-file=", 15) == 0) {
+            Metrics::set_output_file(argv[i] + 15);
+        }
+        else if (strncmp(argv[i], "--metrics-interval=", 19) == 0) {
+            Metrics::set_dump_interval(std::atof(argv[i] + 19));
+        }
+        else if (strncmp(argv[i], "--", 2) == 0) {
+            std::cerr << "Unknown option '" << argv[i] << "'" << std::endl;
+            return 1;
+        }
+        else {
+            filename = argv[i];
+        }
+    }
+
     SymbolTable::register_stdlib();
-    if (argc == 1) {
+    bool success = true;
+    if (filename == nullptr) {
         Shell shell;
         shell.run();
     }
     else {
         FileLoader loader;
-        if (!loader.load_file(argv[1])) {
-            return 1;
-        }
+        success = loader.load_file(filename);
+    }
+    Metrics::shutdown();
+    if (gc::Profiler::enabled()) {
+        gc::Profiler::report(std::cerr);
+    }
+    if (!success) {
+        return 1;
     }
     SymbolTable::destroy();
     return 0;
@@ -0,0 +1,207 @@
+#include "Metrics.hpp"
+#include "BaseObject.hpp"
+#include "Object.hpp"
+#include "HashObject.hpp"
+#include "gc/Heap.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+// Init static attributes
+uint64_t Metrics::nodes_evaluated_ = 0;
+std::vector<std::pair<const char*, uint64_t>> Metrics::allocations_;
+std::unordered_map<FunctionWrapper, Metrics::Builtin> Metrics::builtins_;
+uint64_t Metrics::unregistered_calls_ = 0;
+uint64_t Metrics::gc_cycles_ = 0;
+Metrics::Clock::duration Metrics::gc_pause_total_ = Metrics::Clock::duration::zero();
+Metrics::Clock::duration Metrics::gc_pause_max_ = Metrics::Clock::duration::zero();
+
+std::string                    Metrics::filename_;
+std::chrono::duration<double>  Metrics::interval_(0);
+std::atomic<bool>              Metrics::dump_requested_(false);
+std::thread                    Metrics::timer_;
+std::mutex                     Metrics::timer_mutex_;
+std::condition_variable        Metrics::timer_cv_;
+bool                           Metrics::timer_stop_ = false;
+
+namespace {
+
+double to_seconds(Metrics::Clock::duration duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+}
+
+void Metrics::count_allocation(const BaseObject* object)
+{
+    const char* name = object->class_name();
+    // Only a few classes exist: a linear search is faster than hashing
+    for (auto& entry: allocations_) {
+        if (entry.first == name) {
+            ++entry.second;
+            return;
+        }
+    }
+    allocations_.emplace_back(name, 1);
+}
+
+uint64_t* Metrics::call_counter(FunctionWrapper function)
+{
+    // Map nodes are never moved, even when rehashing
+    auto it = builtins_.find(function);
+    return it != builtins_.end() ? &it->second.calls : &unregistered_calls_;
+}
+
+void Metrics::register_builtin(const std::string& name, FunctionWrapper function)
+{
+    builtins_[function] = Builtin{name, 0};
+}
+
+void Metrics::record_gc(Clock::duration pause)
+{
+    ++gc_cycles_;
+    gc_pause_total_ += pause;
+    if (pause > gc_pause_max_) {
+        gc_pause_max_ = pause;
+    }
+}
+
+Object Metrics::to_hashmap()
+{
+    gc::Heap::Stats heap = gc::Heap::current_stats();
+
+    HashObject* allocations = new HashObject();
+    for (const auto& entry: allocations_) {
+        allocations->push(Object::create_string(entry.first), Object::create_counter(entry.second));
+    }
+    HashObject* calls = new HashObject();
+    for (const auto& kv: builtins_) {
+        calls->push(Object::create_string(kv.second.name), Object::create_counter(kv.second.calls));
+    }
+
+    HashObject* stats = new HashObject();
+    Object result = Object::create_hash(stats);
+    stats->push(Object::create_string("nodes_evaluated"), Object::create_counter(nodes_evaluated_));
+    stats->push(Object::create_string("objects_allocated"), Object::create_hash(allocations));
+    stats->push(Object::create_string("bytes_allocated"), Object::create_counter(gc::Heap::allocated_bytes()));
+    stats->push(Object::create_string("gc_cycles"), Object::create_counter(gc_cycles_));
+    stats->push(Object::create_string("gc_pause_total_ms"), Object::create_float(to_seconds(gc_pause_total_) * 1000));
+    stats->push(Object::create_string("gc_pause_max_ms"), Object::create_float(to_seconds(gc_pause_max_) * 1000));
+    stats->push(Object::create_string("heap_objects"), Object::create_counter(heap.object_count));
+    stats->push(Object::create_string("heap_bytes"), Object::create_counter(heap.used_bytes));
+    stats->push(Object::create_string("heap_pages"), Object::create_counter(heap.page_count));
+    stats->push(Object::create_string("builtin_calls"), Object::create_hash(calls));
+    return result;
+}
+
+void Metrics::write_openmetrics(std::ostream& os)
+{
+    gc::Heap::Stats heap = gc::Heap::current_stats();
+
+    os << "# TYPE aspic_nodes_evaluated counter\n"
+        << "# HELP aspic_nodes_evaluated Syntax tree nodes evaluated.\n"
+        << "aspic_nodes_evaluated_total " << nodes_evaluated_ << "\n";
+
+    os << "# TYPE aspic_objects_allocated counter\n"
+        << "# HELP aspic_objects_allocated Shared objects allocated, by class.\n";
+    for (const auto& entry: allocations_) {
+        os << "aspic_objects_allocated_total{class=\"" << entry.first << "\"} " << entry.second << "\n";
+    }
+
+    os << "# TYPE aspic_allocated_bytes counter\n"
+        << "# UNIT aspic_allocated_bytes bytes\n"
+        << "# HELP aspic_allocated_bytes Heap slot bytes allocated.\n"
+        << "aspic_allocated_bytes_total " << gc::Heap::allocated_bytes() << "\n";
+
+    os << "# TYPE aspic_gc_cycles counter\n"
+        << "# HELP aspic_gc_cycles Garbage collections.\n"
+        << "aspic_gc_cycles_total " << gc_cycles_ << "\n";
+
+    os << "# TYPE aspic_gc_pause_seconds counter\n"
+        << "# UNIT aspic_gc_pause_seconds seconds\n"
+        << "# HELP aspic_gc_pause_seconds Time the interpreter was paused by garbage collections.\n"
+        << "aspic_gc_pause_seconds_total " << to_seconds(gc_pause_total_) << "\n";
+
+    os << "# TYPE aspic_gc_max_pause_seconds gauge\n"
+        << "# UNIT aspic_gc_max_pause_seconds seconds\n"
+        << "# HELP aspic_gc_max_pause_seconds Longest garbage collection pause.\n"
+        << "aspic_gc_max_pause_seconds " << to_seconds(gc_pause_max_) << "\n";
+
+    os << "# TYPE aspic_heap_objects gauge\n"
+        << "# HELP aspic_heap_objects Allocated objects in the heap, including dead objects not swept yet.\n"
+        << "aspic_heap_objects " << heap.object_count << "\n";
+
+    os << "# TYPE aspic_heap_live_bytes gauge\n"
+        << "# UNIT aspic_heap_live_bytes bytes\n"
+        << "# HELP aspic_heap_live_bytes Size of allocated heap slots.\n"
+        << "aspic_heap_live_bytes " << heap.used_bytes << "\n";
+
+    os << "# TYPE aspic_heap_page_bytes gauge\n"
+        << "# UNIT aspic_heap_page_bytes bytes\n"
+        << "# HELP aspic_heap_page_bytes Size of all heap pages.\n"
+        << "aspic_heap_page_bytes " << heap.page_bytes << "\n";
+
+    os << "# TYPE aspic_builtin_calls counter\n"
+        << "# HELP aspic_builtin_calls Built-in function calls, by function name.\n";
+    for (const auto& kv: builtins_) {
+        os << "aspic_builtin_calls_total{function=\"" << kv.second.name << "\"} " << kv.second.calls << "\n";
+    }
+    os << "# EOF" << std::endl;
+}
+
+void Metrics::set_output_file(const std::string& filename)
+{
+    filename_ = filename;
+}
+
+void Metrics::set_dump_interval(double seconds)
+{
+    interval_ = std::chrono::duration<double>(seconds);
+    if (seconds > 0 && !timer_.joinable()) {
+        timer_ = std::thread(run_timer);
+    }
+}
+
+void Metrics::dump()
+{
+    dump_requested_.store(false, std::memory_order_relaxed);
+    if (filename_.empty()) {
+        return;
+    }
+    std::string tmp_filename = filename_ + ".tmp";
+    std::ofstream file(tmp_filename);
+    if (!file) {
+        std::cerr << "Cannot write metrics to '" << tmp_filename << "'" << std::endl;
+        return;
+    }
+    write_openmetrics(file);
+    file.close();
+    if (std::rename(tmp_filename.c_str(), filename_.c_str()) != 0) {
+        std::cerr << "Cannot write metrics to '" << filename_ << "'" << std::endl;
+    }
+}
+
+void Metrics::run_timer()
+{
+    std::unique_lock<std::mutex> lock(timer_mutex_);
+    while (!timer_stop_) {
+        if (!timer_cv_.wait_for(lock, interval_, [] { return timer_stop_; })) {
+            dump_requested_.store(true, std::memory_order_relaxed);
+        }
+    }
+}
+
+void Metrics::shutdown()
+{
+    if (timer_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(timer_mutex_);
+            timer_stop_ = true;
+        }
+        timer_cv_.notify_one();
+        timer_.join();
+    }
+    dump();
+}
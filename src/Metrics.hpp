@@ -0,0 +1,135 @@
+#ifndef ASPIC_METRICS_HPP
+#define ASPIC_METRICS_HPP
+
+#include "FunctionWrapper.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class BaseObject;
+class Object;
+
+/**
+ * Runtime counters: evaluated nodes, allocated objects, garbage collections
+ * and built-in function calls.
+ *
+ * Counters are plain integers updated by the interpreter thread only, so
+ * counting is a single increment. They can be read from scripts (see
+ * runtime_stats built-in function), or dumped in OpenMetrics text format to
+ * a file at exit and periodically. Periodic dumps are requested by a timer
+ * thread, and written by the interpreter thread at the next safepoint.
+ */
+class Metrics
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    static inline void count_node()
+    {
+        ++nodes_evaluated_;
+    }
+
+    /**
+     * Count a new shared object, by class name
+     */
+    static void count_allocation(const BaseObject* object);
+
+    /**
+     * Get the call counter of a built-in function, which callers increment
+     * directly. The pointer remains valid until exit.
+     */
+    static uint64_t* call_counter(FunctionWrapper function);
+
+    /**
+     * Declare a built-in function name, so its calls can be reported
+     */
+    static void register_builtin(const std::string& name, FunctionWrapper function);
+
+    /**
+     * Count a garbage collection, and the time the interpreter was paused
+     */
+    static void record_gc(Clock::duration pause);
+
+    /**
+     * Get all counters in a hashmap object
+     */
+    static Object to_hashmap();
+
+    /**
+     * Print all counters in OpenMetrics text format
+     */
+    static void write_openmetrics(std::ostream& os);
+
+    /**
+     * Set file where counters are written at exit (and at each interval, if any)
+     */
+    static void set_output_file(const std::string& filename);
+
+    /**
+     * Also write counters every given number of seconds (0: only at exit)
+     */
+    static void set_dump_interval(double seconds);
+
+    /**
+     * Called between expressions: write counters if the dump interval elapsed
+     */
+    static inline void safepoint()
+    {
+        if (dump_requested_.load(std::memory_order_relaxed)) {
+            dump();
+        }
+    }
+
+    /**
+     * Stop the timer thread and write counters to the output file
+     */
+    static void shutdown();
+
+private:
+    Metrics() = delete;
+
+    /**
+     * Write counters to the output file. The file is replaced atomically,
+     * so readers never see a partial dump.
+     */
+    static void dump();
+
+    /**
+     * Timer thread loop: request a dump at each interval
+     */
+    static void run_timer();
+
+    struct Builtin
+    {
+        std::string name;
+        uint64_t calls;
+    };
+
+    static uint64_t nodes_evaluated_;
+    static std::vector<std::pair<const char*, uint64_t>> allocations_;
+    static std::unordered_map<FunctionWrapper, Builtin> builtins_;
+    static uint64_t unregistered_calls_; // not reported
+    static uint64_t gc_cycles_;
+    static Clock::duration gc_pause_total_;
+    static Clock::duration gc_pause_max_;
+
+    // Output file
+    static std::string filename_;
+    static std::chrono::duration<double> interval_;
+    static std::atomic<bool> dump_requested_;
+    static std::thread timer_;
+    static std::mutex timer_mutex_;
+    static std::condition_variable timer_cv_;
+    static bool timer_stop_;
+};
+
+#endif
@@ -3,8 +3,25 @@
 #include "Error.hpp"
 #include "ArrayObject.hpp"
 #include "HashObject.hpp"
-
+#include "SetObject.hpp"
+#include "DequeObject.hpp"
+#include "PriorityQueueObject.hpp"
+#include "OrderedMapObject.hpp"
+#include "BitsetObject.hpp"
+#include "VectorObject.hpp"
+#include "LruObject.hpp"
+#include "BloomFilterObject.hpp"
+#include "HyperLogLogObject.hpp"
+#include "CountMinObject.hpp"
+#include "Hash.hpp"
+#include "Metrics.hpp"
+#include "gc/Profiler.hpp"
+#include "gc/Visitor.hpp"
+
+#include <climits>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 
 
 /**
@@ -18,6 +35,17 @@ int absolute_index(int index, int length)
     return index < 0 ? length + index : index;
 }
 
+/**
+ * Convert negative slice bounds and clamp them to [0, length]
+ */
+int slice_bound(int bound, int length)
+{
+    if (bound < 0) {
+        bound += length;
+    }
+    return bound < 0 ? 0 : (bound > length ? length : bound);
+}
+
 // constructors
 
 Object::Object():
@@ -43,6 +71,11 @@ Object Object::create_int(int value)
     return self;
 }
 
+Object Object::create_counter(uint64_t value)
+{
+    return create_int(value > INT_MAX ? INT_MAX : static_cast<int>(value));
+}
+
 Object Object::create_float(double value)
 {
     Object self(FLOAT);
@@ -60,7 +93,9 @@ Object Object::create_bool(bool value)
 Object Object::create_string(const std::string& string)
 {
     Object self(STRING);
+    self.data_.string_hash_ = 0;
     self.string_ = string;
+    gc::Profiler::record_string(string.size());
     return self;
 }
 
@@ -83,38 +118,123 @@ Object Object::create_null()
     return Object(NULL_VALUE);
 }
 
-Object Object::create_array(ArrayObject* array_object)
+Object Object::create_shared(Type type, BaseObject* object)
 {
-    Object self(ARRAY);
-    self.data_.array_ptr_ = array_object;
+    Object self(type);
+    self.data_.object_ptr_ = object;
+    self.retain();
+    Metrics::count_allocation(object);
+    gc::Profiler::record_object(object);
     return self;
 }
 
+Object Object::create_array(ArrayObject* array_object)
+{
+    return create_shared(ARRAY, array_object);
+}
+
 Object Object::create_hash(HashObject* map_object)
 {
-    Object self(HASHMAP);
-    self.data_.hashmap_ptr_ = map_object;
-    return self;
+    return create_shared(HASHMAP, map_object);
 }
 
-void Object::gc_visit() const
+Object Object::create_set(SetObject* set_object)
 {
-    if (type_ == ARRAY) {
-        data_.array_ptr_->mark();
+    return create_shared(SET, set_object);
+}
+
+Object Object::create_deque(DequeObject* deque_object)
+{
+    return create_shared(DEQUE, deque_object);
+}
+
+Object Object::create_pqueue(PriorityQueueObject* queue_object)
+{
+    return create_shared(PQUEUE, queue_object);
+}
+
+Object Object::create_ordmap(OrderedMapObject* map_object)
+{
+    return create_shared(ORDMAP, map_object);
+}
+
+Object Object::create_bitset(BitsetObject* bitset_object)
+{
+    return create_shared(BITSET, bitset_object);
+}
+
+Object Object::create_vector(VectorObject* vector_object)
+{
+    return create_shared(VECTOR, vector_object);
+}
+
+Object Object::create_lru(LruObject* lru_object)
+{
+    return create_shared(LRU, lru_object);
+}
+
+Object Object::create_bloom(BloomFilterObject* bloom_object)
+{
+    return create_shared(BLOOM, bloom_object);
+}
+
+Object Object::create_hll(HyperLogLogObject* hll_object)
+{
+    return create_shared(HLL, hll_object);
+}
+
+Object Object::create_cms(CountMinObject* cms_object)
+{
+    return create_shared(CMS, cms_object);
+}
+
+void Object::gc_visit(gc::Visitor& visitor)
+{
+    if (is_shared()) {
+        visitor.visit(*this);
     }
-    else if (type_ == HASHMAP) {
-        data_.hashmap_ptr_->mark();
+}
+
+BaseObject* Object::get_shared_object() const
+{
+    return is_shared() ? data_.object_ptr_ : nullptr;
+}
+
+void Object::relocate(BaseObject* object)
+{
+    data_.object_ptr_ = object;
+}
+
+template <class T>
+T* Object::shared_as() const
+{
+    return static_cast<T*>(data_.object_ptr_);
+}
+
+template <class T>
+T* Object::get_shared(Type type, const char* expected) const
+{
+    const Object& value = get_value();
+    if (value.type_ == type) {
+        return value.shared_as<T>();
     }
+    throw Error::TypeError(std::string(expected) + " is required");
 }
 
 void Object::assign(const Object& object)
 {
+    // Retain the new value first: it may be owned by the released one
+    object.retain();
+    BaseObject* previous = get_shared_object();
+
     type_ = object.type_;
+    data_ = object.data_;
     if (type_ == STRING) {
         string_ = object.string_;
     }
-    else {
-        data_ = object.data_;
+
+    if (previous != nullptr && gc::RefCount::enabled()) {
+        gc::RefCount::release(previous);
     }
 }
 
@@ -142,6 +262,26 @@ const char* Object::type_to_str(Type type)
             return "array";
         case HASHMAP:
             return "hashmap";
+        case SET:
+            return "set";
+        case DEQUE:
+            return "deque";
+        case PQUEUE:
+            return "pqueue";
+        case ORDMAP:
+            return "ordmap";
+        case BITSET:
+            return "bitset";
+        case VECTOR:
+            return "vector";
+        case LRU:
+            return "lru";
+        case BLOOM:
+            return "bloom";
+        case HLL:
+            return "hll";
+        case CMS:
+            return "cms";
     }
     return nullptr;
 }
@@ -216,10 +356,10 @@ FunctionWrapper Object::get_function() const
 ArrayObject* Object::get_array() const
 {
     if (type_ == ARRAY) {
-        return data_.array_ptr_;
+        return shared_as<ArrayObject>();
     }
     if (type_ == REFERENCE) {
-        return SymbolTable::get(data_.id_hash_).data_.array_ptr_;
+        return SymbolTable::get(data_.id_hash_).shared_as<ArrayObject>();
     }
     throw Error::TypeError("an array is required");
 }
@@ -227,14 +367,64 @@ ArrayObject* Object::get_array() const
 HashObject* Object::get_hashmap() const
 {
     if (type_ == HASHMAP) {
-        return data_.hashmap_ptr_;
+        return shared_as<HashObject>();
     }
     if (type_ == REFERENCE) {
-        return SymbolTable::get(data_.id_hash_).data_.hashmap_ptr_;
+        return SymbolTable::get(data_.id_hash_).shared_as<HashObject>();
     }
     throw Error::TypeError("a hashmap is required");
 }
 
+SetObject* Object::get_set() const
+{
+    return get_shared<SetObject>(SET, "a set");
+}
+
+DequeObject* Object::get_deque() const
+{
+    return get_shared<DequeObject>(DEQUE, "a deque");
+}
+
+PriorityQueueObject* Object::get_pqueue() const
+{
+    return get_shared<PriorityQueueObject>(PQUEUE, "a priority queue");
+}
+
+OrderedMapObject* Object::get_ordmap() const
+{
+    return get_shared<OrderedMapObject>(ORDMAP, "an ordered map");
+}
+
+BitsetObject* Object::get_bitset() const
+{
+    return get_shared<BitsetObject>(BITSET, "a bitset");
+}
+
+VectorObject* Object::get_vector() const
+{
+    return get_shared<VectorObject>(VECTOR, "a vector");
+}
+
+LruObject* Object::get_lru() const
+{
+    return get_shared<LruObject>(LRU, "an lru cache");
+}
+
+BloomFilterObject* Object::get_bloom() const
+{
+    return get_shared<BloomFilterObject>(BLOOM, "a bloom filter");
+}
+
+HyperLogLogObject* Object::get_hll() const
+{
+    return get_shared<HyperLogLogObject>(HLL, "an hll sketch");
+}
+
+CountMinObject* Object::get_cms() const
+{
+    return get_shared<CountMinObject>(CMS, "a count-min sketch");
+}
+
 bool Object::truthy() const
 {
     switch (type_) {
@@ -254,12 +444,10 @@ bool Object::truthy() const
             return true;
         case REFERENCE:
             return SymbolTable::get(data_.id_hash_).truthy();
-        case ARRAY:
-            return true;
-        case HASHMAP:
+        default:
+            // Shared objects are always evaluated as true, even when empty
             return true;
     }
-    return false; // Unreachable, fix -Wreturn-type
 }
 
 std::string Object::to_string() const
@@ -302,6 +490,11 @@ bool Object::equal(const Object& object) const
         case FLOAT:
             return data_.float_ == object.data_.float_;
         case STRING:
+            // Strings with different hashes can't be equal
+            if (data_.string_hash_ != 0 && object.data_.string_hash_ != 0
+                && data_.string_hash_ != object.data_.string_hash_) {
+                return false;
+            }
             return string_ == object.string_;
         case NULL_VALUE:
             return true; // null == null
@@ -310,10 +503,31 @@ bool Object::equal(const Object& object) const
             return data_.function_ptr_ == object.data_.function_ptr_;
         case ARRAY:
             // Forward the operation to ArrayObject
-            return data_.array_ptr_->eq(*object.data_.array_ptr_);
+            return shared_as<ArrayObject>()->eq(*object.shared_as<ArrayObject>());
         case HASHMAP:
             // Forward the operation to HashObject
-            return data_.hashmap_ptr_->eq(*object.data_.hashmap_ptr_);
+            return shared_as<HashObject>()->eq(*object.shared_as<HashObject>());
+        case SET:
+            return shared_as<SetObject>()->eq(*object.shared_as<SetObject>());
+        case DEQUE:
+            return shared_as<DequeObject>()->eq(*object.shared_as<DequeObject>());
+        case PQUEUE:
+            // Priority queues can only be compared by identity
+            return data_.object_ptr_ == object.data_.object_ptr_;
+        case ORDMAP:
+            return shared_as<OrderedMapObject>()->eq(*object.shared_as<OrderedMapObject>());
+        case BITSET:
+            return shared_as<BitsetObject>()->eq(*object.shared_as<BitsetObject>());
+        case VECTOR:
+            return shared_as<VectorObject>()->eq(*object.shared_as<VectorObject>());
+        case LRU:
+            return shared_as<LruObject>()->eq(*object.shared_as<LruObject>());
+        case BLOOM:
+            return shared_as<BloomFilterObject>()->eq(*object.shared_as<BloomFilterObject>());
+        case HLL:
+            return shared_as<HyperLogLogObject>()->eq(*object.shared_as<HyperLogLogObject>());
+        case CMS:
+            return shared_as<CountMinObject>()->eq(*object.shared_as<CountMinObject>());
         case REFERENCE:
             // Object::get_value() must have been called first
             throw Error::InternalError("Object::equal called with REFERENCE object");
@@ -322,15 +536,43 @@ bool Object::equal(const Object& object) const
     }
 }
 
+bool Object::less_than(const Object& object) const
+{
+    if (type_ == INT && object.type_ == INT) {
+        return data_.int_ < object.data_.int_;
+    }
+    if (is_numeric() && object.is_numeric()) {
+        return get_float() < object.get_float();
+    }
+    if (type_ == STRING && object.type_ == STRING) {
+        return string_ < object.string_;
+    }
+    return apply_binary_operator(Operator::OP_LESS_THAN, object).truthy();
+}
+
 size_t Object::size() const
 {
     switch (type_) {
     case STRING:
         return string_.size();
     case ARRAY:
-        return data_.array_ptr_->size();
+        return shared_as<ArrayObject>()->size();
     case HASHMAP:
-        return data_.hashmap_ptr_->size();
+        return shared_as<HashObject>()->size();
+    case SET:
+        return shared_as<SetObject>()->size();
+    case DEQUE:
+        return shared_as<DequeObject>()->size();
+    case PQUEUE:
+        return shared_as<PriorityQueueObject>()->size();
+    case ORDMAP:
+        return shared_as<OrderedMapObject>()->size();
+    case BITSET:
+        return shared_as<BitsetObject>()->size();
+    case VECTOR:
+        return shared_as<VectorObject>()->size();
+    case LRU:
+        return shared_as<LruObject>()->size();
     case REFERENCE:
         return get_value().size();
     default:
@@ -369,6 +611,14 @@ Object Object::apply_unary_operator(Operator op) const
                 return Object::create_bool(!truthy());
             }
             break;
+        case VECTOR:
+            if (op == Operator::OP_UNARY_PLUS) {
+                return *this;
+            }
+            if (op == Operator::OP_UNARY_MINUS) {
+                return VectorObject::apply(Operator::OP_SUBTRACTION, Object::create_int(0), *this);
+            }
+            break;
         case REFERENCE:
             return SymbolTable::get(data_.id_hash_).apply_unary_operator(op);
         default:
@@ -383,11 +633,19 @@ Object Object::apply_binary_operator(Operator op, const Object& operand) const
 {
     switch (type_) {
     case INT:
-        if (operand.contains(FLOAT)) {
+        if (operand.type_ == REFERENCE) {
+            // Resolve the operand once, instead of in each type check and accessor
+            return apply_binary_operator(op, operand.get_value());
+        }
+        if (operand.type_ == FLOAT) {
             // If the other operand is float typed, the result will be also float typed
             Object cast_to_float = Object::create_float(get_float());
             return cast_to_float.apply_binary_operator(op, operand);
         }
+        if (operand.type_ == VECTOR) {
+            // Scalar is broadcast to each element
+            return VectorObject::apply(op, *this, operand);
+        }
 
         switch (op) {
             case Operator::OP_POW:
@@ -405,6 +663,9 @@ Object Object::apply_binary_operator(Operator op, const Object& operand) const
                 if (denominator == 0) {
                     throw Error::DivideByZero();
                 }
+                if (denominator == -1 && get_int() == INT_MIN) {
+                    throw Error::ValueError("integer division overflow");
+                }
                 return Object::create_int(get_int() / denominator);
             }
             case Operator::OP_MODULO:
@@ -413,6 +674,9 @@ Object Object::apply_binary_operator(Operator op, const Object& operand) const
                 if (denominator == 0) {
                     throw Error::DivideByZero();
                 }
+                if (denominator == -1 && get_int() == INT_MIN) {
+                    throw Error::ValueError("integer division overflow");
+                }
                 return Object::create_int(get_int() % denominator);
             }
             case Operator::OP_ADDITION:
@@ -438,6 +702,12 @@ Object Object::apply_binary_operator(Operator op, const Object& operand) const
         break;
 
     case FLOAT:
+        if (operand.type_ == REFERENCE) {
+            return apply_binary_operator(op, operand.get_value());
+        }
+        if (operand.type_ == VECTOR) {
+            return VectorObject::apply(op, *this, operand);
+        }
         switch (op) {
             case Operator::OP_POW:
                 return Object::create_float(std::pow(get_float(), operand.get_float()));
@@ -527,10 +797,10 @@ Object Object::apply_binary_operator(Operator op, const Object& operand) const
         switch (op) {
         case Operator::OP_INDEX:
             if (operand.contains(INT)) {
-                int index = absolute_index(operand.get_int(), data_.array_ptr_->size());
+                int index = absolute_index(operand.get_int(), shared_as<ArrayObject>()->size());
 
                 // Return value located at index
-                return data_.array_ptr_->at(index);
+                return shared_as<ArrayObject>()->at(index);
             }
             else {
                 throw Error::UnsupportedBinaryOperator(type_, operand.get_value_type(), op);
@@ -539,7 +809,7 @@ Object Object::apply_binary_operator(Operator op, const Object& operand) const
 
         case Operator::OP_ADDITION:
             return Object::create_array(ArrayObject::concat(
-                *data_.array_ptr_,
+                *shared_as<ArrayObject>(),
                 *operand.get_array()
             ));
 
@@ -551,12 +821,38 @@ Object Object::apply_binary_operator(Operator op, const Object& operand) const
     case HASHMAP:
         switch (op) {
         case Operator::OP_INDEX:
-            return data_.hashmap_ptr_->at(operand);
+            return shared_as<HashObject>()->at(operand);
         default:
             break;
         }
         break;
 
+    case DEQUE:
+        if (op == Operator::OP_INDEX) {
+            if (operand.contains(INT)) {
+                int index = absolute_index(operand.get_int(), shared_as<DequeObject>()->size());
+                return shared_as<DequeObject>()->at(index);
+            }
+            throw Error::UnsupportedBinaryOperator(type_, operand.get_value_type(), op);
+        }
+        break;
+
+    case ORDMAP:
+        if (op == Operator::OP_INDEX) {
+            return shared_as<OrderedMapObject>()->at(operand);
+        }
+        break;
+
+    case VECTOR:
+        if (op == Operator::OP_INDEX) {
+            if (operand.contains(INT)) {
+                int index = absolute_index(operand.get_int(), shared_as<VectorObject>()->size());
+                return shared_as<VectorObject>()->at(index);
+            }
+            throw Error::UnsupportedBinaryOperator(type_, operand.get_value_type(), op);
+        }
+        return VectorObject::apply(op, *this, operand.get_value());
+
     case REFERENCE:
         switch (op) {
             // Handle operators which update the variable value, operand is the assigned lvalue
@@ -623,10 +919,67 @@ Object Object::multiply_string(const std::string& source, int count)
     for (int i = 0; i < count; ++i) {
         result.string_ += source;
     }
+    gc::Profiler::record_string(result.string_.size());
     return result;
 }
 
 
+Object Object::slice(int start, int end) const
+{
+    const Object& value = get_value();
+    if (value.type_ != STRING && value.type_ != ARRAY) {
+        throw Error::TypeError(std::string("type '") + type_to_str(value.type_) + "' cannot be sliced");
+    }
+    int length = value.size();
+    start = slice_bound(start, length);
+    end = slice_bound(end, length);
+    if (end < start) {
+        end = start;
+    }
+    if (value.type_ == STRING) {
+        return create_string(value.string_.substr(start, end - start));
+    }
+    return create_array(ArrayObject::slice(*value.shared_as<ArrayObject>(), start, end));
+}
+
+Object Object::assign_element(Operator op, const Object& index, const Object& value) const
+{
+    const Object& target = get_value();
+    const Object& v = value.get_value();
+    switch (target.type_) {
+    case ARRAY:
+    {
+        ArrayObject* array = target.shared_as<ArrayObject>();
+        if (!index.contains(INT)) {
+            throw Error::UnsupportedBinaryOperator(ARRAY, index.get_value_type(), Operator::OP_INDEX);
+        }
+        size_t i = absolute_index(index.get_int(), array->size());
+        if (op == Operator::OP_ASSIGNMENT) {
+            array->set(i, v);
+            return v;
+        }
+        // Packed elements aren't Object values: the result is stored back
+        Object result = array->at(i).apply_binary_operator(Operators::compound_operator(op), v);
+        array->set(i, result);
+        return result;
+    }
+    case HASHMAP:
+    {
+        HashObject* map = target.shared_as<HashObject>();
+        if (op == Operator::OP_ASSIGNMENT) {
+            map->push(index, v);
+            return v;
+        }
+        // Update the value slot, a compound assignment doesn't add keys
+        Object& element = map->at(index);
+        element.assign(element.apply_binary_operator(Operators::compound_operator(op), v));
+        return element;
+    }
+    default:
+        throw Error::TypeError(std::string("type '") + type_to_str(target.type_) + "' does not support element assignment");
+    }
+}
+
 std::ostream& Object::print(std::ostream& os, size_t recursion_depth) const
 {
     if (recursion_depth > 10) {
@@ -658,29 +1011,133 @@ std::ostream& Object::print(std::ostream& os, size_t recursion_depth) const
             break;
         case Object::ARRAY:
             os << '[';
-            for (size_t i = 0; i < data_.array_ptr_->size(); ++i) {
+            for (size_t i = 0; i < shared_as<ArrayObject>()->size(); ++i) {
                 if (i > 0) {
                     os << ", ";
                 }
-                data_.array_ptr_->at(i).print(os, recursion_depth + 1);
+                shared_as<ArrayObject>()->at(i).print(os, recursion_depth + 1);
             }
             os << ']';
             break;
         case Object::HASHMAP:
             os << '{';
-            int n = 0;
-            for (HashObject::InternalHash::const_iterator it = data_.hashmap_ptr_->begin();
-                it != data_.hashmap_ptr_->end(); ++it) {
-                if (n > 0) {
+            for (size_t i = 0; i < shared_as<HashObject>()->size(); ++i) {
+                if (i > 0) {
                     os << ", ";
                 }
-                it->first.print(os, recursion_depth + 1);
+                shared_as<HashObject>()->key_at(i).print(os, recursion_depth + 1);
                 os << ": ";
-                it->second.print(os, recursion_depth + 1);
-                ++n;
+                shared_as<HashObject>()->value_at(i).print(os, recursion_depth + 1);
             }
             os << '}';
             break;
+        case Object::SET:
+            // {} is an empty hashmap
+            if (shared_as<SetObject>()->size() == 0) {
+                os << "set()";
+                break;
+            }
+            os << '{';
+            for (size_t i = 0; i < shared_as<SetObject>()->size(); ++i) {
+                if (i > 0) {
+                    os << ", ";
+                }
+                shared_as<SetObject>()->at(i).print(os, recursion_depth + 1);
+            }
+            os << '}';
+            break;
+        case Object::DEQUE:
+            os << "deque([";
+            for (size_t i = 0; i < shared_as<DequeObject>()->size(); ++i) {
+                if (i > 0) {
+                    os << ", ";
+                }
+                shared_as<DequeObject>()->at(i).print(os, recursion_depth + 1);
+            }
+            os << "])";
+            break;
+        case Object::PQUEUE:
+        {
+            // Values are printed in pop order
+            std::vector<Object> values = shared_as<PriorityQueueObject>()->sorted_values();
+            os << "pqueue([";
+            for (size_t i = 0; i < values.size(); ++i) {
+                if (i > 0) {
+                    os << ", ";
+                }
+                values[i].print(os, recursion_depth + 1);
+            }
+            os << "])";
+            break;
+        }
+        case Object::ORDMAP:
+        {
+            bool first = true;
+            os << "ordmap({";
+            shared_as<OrderedMapObject>()->for_each([&](const Object& key, const Object& value) {
+                if (!first) {
+                    os << ", ";
+                }
+                first = false;
+                key.print(os, recursion_depth + 1);
+                os << ": ";
+                value.print(os, recursion_depth + 1);
+            });
+            os << "})";
+            break;
+        }
+        case Object::BITSET:
+        {
+            // Printed as the bitset() call creating it
+            bool first = true;
+            os << "bitset(" << shared_as<BitsetObject>()->size() << ", [";
+            shared_as<BitsetObject>()->for_each_index([&](size_t index) {
+                if (!first) {
+                    os << ", ";
+                }
+                first = false;
+                os << index;
+            });
+            os << "])";
+            break;
+        }
+        case Object::VECTOR:
+            os << "vector([";
+            for (size_t i = 0; i < shared_as<VectorObject>()->size(); ++i) {
+                if (i > 0) {
+                    os << ", ";
+                }
+                shared_as<VectorObject>()->at(i).print(os, recursion_depth + 1);
+            }
+            os << "])";
+            break;
+        case Object::LRU:
+        {
+            // Entries are printed from the most recently used
+            bool first = true;
+            os << "lru({";
+            shared_as<LruObject>()->for_each([&](const Object& key, const Object& value) {
+                if (!first) {
+                    os << ", ";
+                }
+                first = false;
+                key.print(os, recursion_depth + 1);
+                os << ": ";
+                value.print(os, recursion_depth + 1);
+            });
+            os << "})";
+            break;
+        }
+        // Sketches only print their size, values aren't stored
+        case Object::BLOOM:
+            os << "bloom(" << shared_as<BloomFilterObject>()->bit_count() << " bits, " << shared_as<BloomFilterObject>()->hash_count() << " hashes)";
+            break;
+        case Object::HLL:
+            os << "hll(precision " << shared_as<HyperLogLogObject>()->precision() << ")";
+            break;
+        case Object::CMS:
+            os << "cms(" << shared_as<CountMinObject>()->width() << "x" << shared_as<CountMinObject>()->depth() << " counters)";
+            break;
     }
     return os;
 }
@@ -692,6 +1149,14 @@ std::ostream& operator<<(std::ostream& os, const Object& object)
 }
 
 
+size_t Object::string_hash() const
+{
+    if (data_.string_hash_ == 0) {
+        data_.string_hash_ = Hash::bytes(string_.data(), string_.size());
+    }
+    return data_.string_hash_;
+}
+
 bool Object::operator==(const Object& object) const
 {
     return equal(object);
@@ -702,13 +1167,27 @@ size_t hash<Object>::operator()(const Object& object) const
 {
     switch (object.type_) {
     case Object::INT:
-        return std::hash<int>{}(object.data_.int_);
+        return Hash::integer(object.data_.int_);
     case Object::FLOAT:
-        return std::hash<float>{}(object.data_.float_);
+    {
+        // Integral floats hash as the equal int value (1.0 == 1), -0.0 as 0
+        double value = object.data_.float_;
+        if (value >= -9223372036854775808.0 && value < 9223372036854775808.0 && value == std::trunc(value)) {
+            return Hash::integer(static_cast<int64_t>(value));
+        }
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return Hash::integer(bits);
+    }
     case Object::BOOL:
-        return std::hash<bool>{}(object.data_.bool_);
+        return Hash::integer(object.data_.bool_ ? 0x9e3779b97f4a7c15ull : 0x7f4a7c159e3779b9ull);
     case Object::STRING:
-        return std::hash<std::string>{}(object.string_);
+        return object.string_hash();
+    case Object::ARRAY:
+        if (object.shared_as<ArrayObject>()->is_frozen()) {
+            return object.shared_as<ArrayObject>()->hash();
+        }
+        throw Error::TypeError("array is not hashable type, unless frozen (see freeze)");
     default:
         break;
     }
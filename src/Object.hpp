@@ -3,12 +3,27 @@
 
 #include "Operators.hpp"
 #include "FunctionWrapper.hpp"
+#include "gc/RefCount.hpp"
 
+#include <cstdint>
 #include <string>
 #include <iostream>
 
 class ArrayObject;
 class HashObject;
+class SetObject;
+class DequeObject;
+class PriorityQueueObject;
+class OrderedMapObject;
+class BitsetObject;
+class VectorObject;
+class LruObject;
+class BloomFilterObject;
+class HyperLogLogObject;
+class CountMinObject;
+class BaseObject;
+
+namespace gc { class Visitor; }
 
 class Object
 {
@@ -22,18 +37,34 @@ public:
         BUILTIN_FUNCTION,
         REFERENCE,
         NULL_VALUE,
+        // Shared object types, must remain last (see is_shared)
         ARRAY,
-        HASHMAP
+        HASHMAP,
+        SET,
+        DEQUE,
+        PQUEUE,
+        ORDMAP,
+        BITSET,
+        VECTOR,
+        LRU,
+        BLOOM,
+        HLL,
+        CMS
     };
 
     // Constructors
 
     Object();
+    Object(const Object& object);
+    Object(Object&& object) noexcept;
+    ~Object();
     Object& operator=(const Object& object);
 
     bool operator==(const Object& object) const;
 
     static Object create_int(int value);
+    // Aspic integers are 32 bits: counts above INT_MAX are saturated
+    static Object create_counter(uint64_t value);
     static Object create_float(double value);
     static Object create_bool(bool value);
     static Object create_string(const std::string& string);
@@ -42,8 +73,40 @@ public:
     static Object create_null();
     static Object create_array(ArrayObject* array);
     static Object create_hash(HashObject* hash);
+    static Object create_set(SetObject* set);
+    static Object create_deque(DequeObject* deque);
+    static Object create_pqueue(PriorityQueueObject* queue);
+    static Object create_ordmap(OrderedMapObject* map);
+    static Object create_bitset(BitsetObject* bitset);
+    static Object create_vector(VectorObject* vector);
+    static Object create_lru(LruObject* lru);
+    static Object create_bloom(BloomFilterObject* filter);
+    static Object create_hll(HyperLogLogObject* sketch);
+    static Object create_cms(CountMinObject* sketch);
 
-    void gc_visit() const;
+    /**
+     * Invoke visitor if object references a shared object
+     */
+    void gc_visit(gc::Visitor& visitor);
+
+    /**
+     * Get referenced shared object (array, hashmap), or nullptr for values
+     */
+    BaseObject* get_shared_object() const;
+
+    /**
+     * Point to the new address of the referenced shared object, after it has
+     * been moved by heap compaction
+     */
+    void relocate(BaseObject* object);
+
+    /**
+     * Check if object references a shared object, stored in the gc::Heap
+     */
+    inline bool is_shared() const
+    {
+        return type_ >= ARRAY;
+    }
 
     // Types
 
@@ -67,14 +130,36 @@ public:
     FunctionWrapper get_function() const;
     ArrayObject* get_array() const;
     HashObject* get_hashmap() const;
+    SetObject* get_set() const;
+    DequeObject* get_deque() const;
+    PriorityQueueObject* get_pqueue() const;
+    OrderedMapObject* get_ordmap() const;
+    BitsetObject* get_bitset() const;
+    VectorObject* get_vector() const;
+    LruObject* get_lru() const;
+    BloomFilterObject* get_bloom() const;
+    HyperLogLogObject* get_hll() const;
+    CountMinObject* get_cms() const;
     bool truthy() const;
 
     std::string to_string() const;
 
+    /**
+     * Get hash of a string, computed on first call
+     * Copies made afterwards keep the cached value.
+     */
+    size_t string_hash() const;
+
     // Operations
 
     bool equal(const Object& object) const;
 
+    /**
+     * Compare with the < operator, without creating a bool object
+     * Throw UnsupportedBinaryOperator or TypeError if objects can't be compared
+     */
+    bool less_than(const Object& object) const;
+
     /**
      * Get size of object, if object is an enumerable (string, array, hashmap)
      * Throw ValueError if object has no length
@@ -91,6 +176,20 @@ public:
 
     Object apply_binary_operator(Operator op, const Object& operand) const;
 
+    /**
+     * Get elements in range [start, end) of a string or an array
+     * Negative bounds are relative to the end, bounds are clamped to size.
+     * Array slices may share elements with the array (see ArrayObject::slice)
+     */
+    Object slice(int start, int end) const;
+
+    /**
+     * Assign the element at index of an array or a hashmap, or update it with
+     * a compound assignment operator (+=, ...), in place
+     * @return new element value
+     */
+    Object assign_element(Operator op, const Object& index, const Object& value) const;
+
     std::ostream& print(std::ostream& os, size_t recursion_depth) const;
 
 private:
@@ -111,6 +210,32 @@ private:
     // helper function for str * int operation
     static Object multiply_string(const std::string& source, int count);
 
+    /**
+     * Create an object holding a shared object, and count its allocation
+     */
+    static Object create_shared(Type type, BaseObject* object);
+
+    // Typed accessor to the shared object pointer
+    template <class T>
+    T* shared_as() const;
+
+    /**
+     * Get shared object of the given type, also through a reference
+     * Throw TypeError "<expected> is required" otherwise
+     */
+    template <class T>
+    T* get_shared(Type type, const char* expected) const;
+
+    /**
+     * Add a reference to the shared object, in reference counting mode
+     */
+    inline void retain() const
+    {
+        if (is_shared() && gc::RefCount::enabled()) {
+            gc::RefCount::retain(data_.object_ptr_);
+        }
+    }
+
     Object(Type type);
 
     Type type_;
@@ -122,8 +247,8 @@ private:
         bool bool_;
         FunctionWrapper function_ptr_;
         size_t id_hash_;
-        ArrayObject* array_ptr_;
-        HashObject* hashmap_ptr_;
+        BaseObject* object_ptr_; // Shared object types (see is_shared)
+        mutable size_t string_hash_; // STRING: cached hash of string_, 0 if not computed yet
     };
 
     Data data_;
@@ -131,6 +256,32 @@ private:
     std::string string_;
 };
 
+inline Object::Object(const Object& object):
+    type_(object.type_),
+    data_(object.data_)
+{
+    if (type_ == STRING) {
+        string_ = object.string_;
+    }
+    retain();
+}
+
+inline Object::Object(Object&& object) noexcept:
+    type_(object.type_),
+    data_(object.data_),
+    string_(std::move(object.string_))
+{
+    // Moved-from object doesn't hold a reference anymore
+    object.type_ = NULL_VALUE;
+}
+
+inline Object::~Object()
+{
+    if (is_shared() && gc::RefCount::enabled()) {
+        gc::RefCount::release(data_.object_ptr_);
+    }
+}
+
 namespace std {
 
 /**
@@ -219,3 +219,36 @@ const char* Operators::to_str(Operator op)
     }
     return nullptr;
 }
+
+bool Operators::is_assignment(Operator op)
+{
+    switch (op) {
+        case Operator::OP_ASSIGNMENT:
+        case Operator::OP_MULTIPLY_AND_ASSIGN:
+        case Operator::OP_DIVIDE_AND_ASSIGN:
+        case Operator::OP_MODULO_AND_ASSIGN:
+        case Operator::OP_ADD_AND_ASSIGN:
+        case Operator::OP_SUBTRACT_AND_ASSIGN:
+            return true;
+        default:
+            return false;
+    }
+}
+
+Operator Operators::compound_operator(Operator op)
+{
+    switch (op) {
+        case Operator::OP_MULTIPLY_AND_ASSIGN:
+            return Operator::OP_MULTIPLICATION;
+        case Operator::OP_DIVIDE_AND_ASSIGN:
+            return Operator::OP_DIVISION;
+        case Operator::OP_MODULO_AND_ASSIGN:
+            return Operator::OP_MODULO;
+        case Operator::OP_ADD_AND_ASSIGN:
+            return Operator::OP_ADDITION;
+        case Operator::OP_SUBTRACT_AND_ASSIGN:
+            return Operator::OP_SUBTRACTION;
+        default:
+            return op;
+    }
+}
@@ -51,6 +51,16 @@ public:
 
     static const char* to_str(Operator op);
 
+    /**
+     * Check if operator assigns its left operand (=, +=, ...)
+     */
+    static bool is_assignment(Operator op);
+
+    /**
+     * Get operator applied by a compound assignment (OP_ADDITION for +=)
+     */
+    static Operator compound_operator(Operator op);
+
 private:
     Operators() = delete;
 };
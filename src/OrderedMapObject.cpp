@@ -0,0 +1,441 @@
+#include "OrderedMapObject.hpp"
+#include "ArrayObject.hpp"
+#include "Error.hpp"
+
+#include <new>
+
+// Init static attributes
+const size_t OrderedMapObject::MIN_DEGREE;
+const size_t OrderedMapObject::MAX_KEYS;
+
+
+OrderedMapObject::OrderedMapObject():
+    BaseObject(),
+    root_(nullptr),
+    size_(0)
+{
+}
+
+OrderedMapObject::OrderedMapObject(OrderedMapObject&& map):
+    BaseObject(map),
+    root_(map.root_),
+    size_(map.size_)
+{
+    map.root_ = nullptr;
+    map.size_ = 0;
+}
+
+OrderedMapObject::~OrderedMapObject()
+{
+    destroy(root_);
+}
+
+void OrderedMapObject::destroy(Node* node)
+{
+    if (node != nullptr) {
+        for (Node* child: node->children) {
+            destroy(child);
+        }
+        delete node;
+    }
+}
+
+const char* OrderedMapObject::class_name() const
+{
+    return "ordmap";
+}
+
+size_t OrderedMapObject::size() const
+{
+    return size_;
+}
+
+void OrderedMapObject::check_key(const Object& key) const
+{
+    Object::Type type = key.get_type();
+    if (type != Object::INT && type != Object::FLOAT && type != Object::STRING) {
+        throw Error::TypeError("ordered map keys must be numbers or strings");
+    }
+    if (size_ > 0 && (type == Object::STRING) != (root_->keys[0].get_type() == Object::STRING)) {
+        throw Error::TypeError("ordered map keys must be all numbers or all strings");
+    }
+}
+
+size_t OrderedMapObject::search(const Node& node, const Object& key)
+{
+    size_t low = 0;
+    size_t high = node.keys.size();
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (node.keys[middle].less_than(key)) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+bool OrderedMapObject::matches(const Node& node, size_t position, const Object& key)
+{
+    // keys[position] isn't less than key: keys are equal if key isn't less either
+    return position < node.keys.size() && !key.less_than(node.keys[position]);
+}
+
+const Object* OrderedMapObject::find(const Object& key) const
+{
+    const Object& k = key.get_value();
+    check_key(k);
+    const Node* node = root_;
+    while (node != nullptr) {
+        size_t i = search(*node, k);
+        if (matches(*node, i, k)) {
+            return &node->values[i];
+        }
+        node = node->leaf() ? nullptr : node->children[i];
+    }
+    return nullptr;
+}
+
+const Object& OrderedMapObject::at(const Object& key) const
+{
+    const Object* value = find(key);
+    if (value == nullptr) {
+        throw Error::KeyError(key.get_value().to_string());
+    }
+    return *value;
+}
+
+void OrderedMapObject::split_child(Node& node, size_t position)
+{
+    Node& child = *node.children[position];
+    Node* sibling = new Node();
+    sibling->keys.assign(child.keys.begin() + MIN_DEGREE, child.keys.end());
+    sibling->values.assign(child.values.begin() + MIN_DEGREE, child.values.end());
+    if (!child.leaf()) {
+        sibling->children.assign(child.children.begin() + MIN_DEGREE, child.children.end());
+        child.children.resize(MIN_DEGREE);
+    }
+    node.keys.insert(node.keys.begin() + position, child.keys[MIN_DEGREE - 1]);
+    node.values.insert(node.values.begin() + position, child.values[MIN_DEGREE - 1]);
+    node.children.insert(node.children.begin() + position + 1, sibling);
+    child.keys.resize(MIN_DEGREE - 1);
+    child.values.resize(MIN_DEGREE - 1);
+}
+
+void OrderedMapObject::set(const Object& key, const Object& value)
+{
+    // get_value() ensures identifier references aren't stored in the map
+    const Object& k = key.get_value();
+    const Object& v = value.get_value();
+    check_key(k);
+    if (root_ == nullptr) {
+        root_ = new Node();
+    }
+    else if (root_->full()) {
+        Node* root = new Node();
+        root->children.push_back(root_);
+        root_ = root;
+        split_child(*root_, 0);
+    }
+    // Full nodes are split on the way down, so a leaf always has room
+    Node* node = root_;
+    for (;;) {
+        size_t i = search(*node, k);
+        if (matches(*node, i, k)) {
+            node->values[i] = v;
+            return;
+        }
+        if (node->leaf()) {
+            node->keys.insert(node->keys.begin() + i, k);
+            node->values.insert(node->values.begin() + i, v);
+            ++size_;
+            return;
+        }
+        if (node->children[i]->full()) {
+            split_child(*node, i);
+            if (node->keys[i].less_than(k)) {
+                ++i;
+            }
+            else if (!k.less_than(node->keys[i])) {
+                node->values[i] = v;
+                return;
+            }
+        }
+        node = node->children[i];
+    }
+}
+
+void OrderedMapObject::merge_children(Node& node, size_t position)
+{
+    Node& child = *node.children[position];
+    Node* sibling = node.children[position + 1];
+    child.keys.push_back(node.keys[position]);
+    child.values.push_back(node.values[position]);
+    child.keys.insert(child.keys.end(), sibling->keys.begin(), sibling->keys.end());
+    child.values.insert(child.values.end(), sibling->values.begin(), sibling->values.end());
+    child.children.insert(child.children.end(), sibling->children.begin(), sibling->children.end());
+    node.keys.erase(node.keys.begin() + position);
+    node.values.erase(node.values.begin() + position);
+    node.children.erase(node.children.begin() + position + 1);
+    delete sibling;
+}
+
+size_t OrderedMapObject::fill_child(Node& node, size_t position)
+{
+    Node& child = *node.children[position];
+    if (child.keys.size() >= MIN_DEGREE) {
+        return position;
+    }
+    if (position > 0 && node.children[position - 1]->keys.size() >= MIN_DEGREE) {
+        // Rotate last key of left sibling through parent
+        Node& left = *node.children[position - 1];
+        child.keys.insert(child.keys.begin(), node.keys[position - 1]);
+        child.values.insert(child.values.begin(), node.values[position - 1]);
+        node.keys[position - 1] = left.keys.back();
+        node.values[position - 1] = left.values.back();
+        left.keys.pop_back();
+        left.values.pop_back();
+        if (!left.leaf()) {
+            child.children.insert(child.children.begin(), left.children.back());
+            left.children.pop_back();
+        }
+        return position;
+    }
+    if (position < node.keys.size() && node.children[position + 1]->keys.size() >= MIN_DEGREE) {
+        // Rotate first key of right sibling through parent
+        Node& right = *node.children[position + 1];
+        child.keys.push_back(node.keys[position]);
+        child.values.push_back(node.values[position]);
+        node.keys[position] = right.keys.front();
+        node.values[position] = right.values.front();
+        right.keys.erase(right.keys.begin());
+        right.values.erase(right.values.begin());
+        if (!right.leaf()) {
+            child.children.push_back(right.children.front());
+            right.children.erase(right.children.begin());
+        }
+        return position;
+    }
+    if (position < node.keys.size()) {
+        merge_children(node, position);
+        return position;
+    }
+    merge_children(node, position - 1);
+    return position - 1;
+}
+
+bool OrderedMapObject::remove(Node& node, const Object& key)
+{
+    size_t i = search(node, key);
+    if (matches(node, i, key)) {
+        if (node.leaf()) {
+            node.keys.erase(node.keys.begin() + i);
+            node.values.erase(node.values.begin() + i);
+            return true;
+        }
+        if (node.children[i]->keys.size() >= MIN_DEGREE) {
+            // Replace with predecessor, then remove it from the left subtree
+            const Node* last = node.children[i];
+            while (!last->leaf()) {
+                last = last->children.back();
+            }
+            node.keys[i] = last->keys.back();
+            node.values[i] = last->values.back();
+            return remove(*node.children[i], node.keys[i]);
+        }
+        if (node.children[i + 1]->keys.size() >= MIN_DEGREE) {
+            // Replace with successor, then remove it from the right subtree
+            const Node* first = node.children[i + 1];
+            while (!first->leaf()) {
+                first = first->children.front();
+            }
+            node.keys[i] = first->keys.front();
+            node.values[i] = first->values.front();
+            return remove(*node.children[i + 1], node.keys[i]);
+        }
+        merge_children(node, i);
+        return remove(*node.children[i], key);
+    }
+    if (node.leaf()) {
+        return false;
+    }
+    i = fill_child(node, i);
+    return remove(*node.children[i], key);
+}
+
+bool OrderedMapObject::remove(const Object& key)
+{
+    const Object& k = key.get_value();
+    check_key(k);
+    if (root_ == nullptr || !remove(*root_, k)) {
+        return false;
+    }
+    --size_;
+    // Root is dropped when emptied, the tree height shrinks
+    if (root_->keys.empty()) {
+        Node* root = root_;
+        root_ = root->leaf() ? nullptr : root->children[0];
+        root->children.clear();
+        delete root;
+    }
+    return true;
+}
+
+const Object& OrderedMapObject::min_key() const
+{
+    if (size_ == 0) {
+        throw Error::ValueError("ordered map is empty");
+    }
+    const Node* node = root_;
+    while (!node->leaf()) {
+        node = node->children.front();
+    }
+    return node->keys.front();
+}
+
+const Object& OrderedMapObject::max_key() const
+{
+    if (size_ == 0) {
+        throw Error::ValueError("ordered map is empty");
+    }
+    const Node* node = root_;
+    while (!node->leaf()) {
+        node = node->children.back();
+    }
+    return node->keys.back();
+}
+
+const Object* OrderedMapObject::lower_bound(const Object& key) const
+{
+    const Object& k = key.get_value();
+    check_key(k);
+    const Object* result = nullptr;
+    const Node* node = root_;
+    while (node != nullptr) {
+        size_t i = search(*node, k);
+        if (i < node->keys.size()) {
+            result = &node->keys[i];
+            if (!k.less_than(*result)) {
+                break;
+            }
+        }
+        node = node->leaf() ? nullptr : node->children[i];
+    }
+    return result;
+}
+
+ArrayObject* OrderedMapObject::get_keys() const
+{
+    ArrayObject* array = new ArrayObject(size_);
+    for_each([array](const Object& key, const Object&) {
+        array->push(key);
+    });
+    return array;
+}
+
+ArrayObject* OrderedMapObject::get_values() const
+{
+    ArrayObject* array = new ArrayObject(size_);
+    for_each([array](const Object&, const Object& value) {
+        array->push(value);
+    });
+    return array;
+}
+
+bool OrderedMapObject::range(const Node& node, const Object& low, const Object& high, ArrayObject& result)
+{
+    // Children before the first key not less than low only hold smaller keys
+    for (size_t i = search(node, low); i <= node.keys.size(); ++i) {
+        if (!node.leaf() && !range(*node.children[i], low, high, result)) {
+            return false;
+        }
+        if (i == node.keys.size()) {
+            break;
+        }
+        if (!node.keys[i].less_than(high)) {
+            return false;
+        }
+        ArrayObject* pair = new ArrayObject(2);
+        result.push(Object::create_array(pair));
+        pair->push(node.keys[i]);
+        pair->push(node.values[i]);
+    }
+    return true;
+}
+
+ArrayObject* OrderedMapObject::range(const Object& low, const Object& high) const
+{
+    const Object& l = low.get_value();
+    const Object& h = high.get_value();
+    check_key(l);
+    check_key(h);
+    ArrayObject* array = new ArrayObject();
+    if (root_ != nullptr) {
+        range(*root_, l, h, *array);
+    }
+    return array;
+}
+
+bool OrderedMapObject::eq(const OrderedMapObject& map) const
+{
+    if (this == &map) {
+        return true;
+    }
+    if (size_ != map.size_) {
+        return false;
+    }
+    std::vector<const Object*> entries;
+    entries.reserve(size_ * 2);
+    map.for_each([&entries](const Object& key, const Object& value) {
+        entries.push_back(&key);
+        entries.push_back(&value);
+    });
+    size_t i = 0;
+    bool equal = true;
+    for_each([&](const Object& key, const Object& value) {
+        equal = equal && key.equal(*entries[i]) && value.get_value().equal(entries[i + 1]->get_value());
+        i += 2;
+    });
+    return equal;
+}
+
+void OrderedMapObject::gc_visit(Node& node, gc::Visitor& visitor)
+{
+    // Keys are numbers or strings, only values may be shared objects
+    for (auto& value: node.values) {
+        value.gc_visit(visitor);
+    }
+    for (Node* child: node.children) {
+        gc_visit(*child, visitor);
+    }
+}
+
+void OrderedMapObject::gc_visit(gc::Visitor& visitor)
+{
+    if (root_ != nullptr) {
+        gc_visit(*root_, visitor);
+    }
+}
+
+BaseObject* OrderedMapObject::move_to(void* slot)
+{
+    return ::new (slot) OrderedMapObject(std::move(*this));
+}
+
+size_t OrderedMapObject::external_size(const Node& node)
+{
+    size_t size = sizeof(Node)
+        + (node.keys.capacity() + node.values.capacity()) * sizeof(Object)
+        + node.children.capacity() * sizeof(Node*);
+    for (const Node* child: node.children) {
+        size += external_size(*child);
+    }
+    return size;
+}
+
+size_t OrderedMapObject::external_size() const
+{
+    return root_ != nullptr ? external_size(*root_) : 0;
+}
@@ -0,0 +1,190 @@
+#ifndef ASPIC_ORDERED_MAP_OBJECT_HPP
+#define ASPIC_ORDERED_MAP_OBJECT_HPP
+
+#include "BaseObject.hpp"
+#include "Object.hpp"
+
+#include <vector>
+
+class ArrayObject;
+
+/**
+ * A map sorted by keys, implemented as a B-tree
+ *
+ * Keys are either all numbers or all strings, and are ordered with the <
+ * operator. Each node stores up to MAX_KEYS keys and values in contiguous
+ * vectors, so lookups mostly scan memory sequentially.
+ */
+class OrderedMapObject: public BaseObject
+{
+public:
+    OrderedMapObject();
+    ~OrderedMapObject();
+
+    const char* class_name() const override;
+
+    /**
+     * Get number of keys
+     */
+    size_t size() const;
+
+    /**
+     * Add a key, or replace its value
+     */
+    void set(const Object& key, const Object& value);
+
+    /**
+     * Get value for a key, or nullptr if key is missing
+     */
+    const Object* find(const Object& key) const;
+
+    /**
+     * Get value for a key
+     * Throw KeyError if key is missing
+     */
+    const Object& at(const Object& key) const;
+
+    /**
+     * Remove a key
+     * @return false if key was missing
+     */
+    bool remove(const Object& key);
+
+    /**
+     * Get smallest and largest keys
+     * Throw ValueError if map is empty
+     */
+    const Object& min_key() const;
+    const Object& max_key() const;
+
+    /**
+     * Get first key greater than or equal to a key, or nullptr
+     */
+    const Object* lower_bound(const Object& key) const;
+
+    /**
+     * Get keys or values, in key order
+     */
+    ArrayObject* get_keys() const;
+    ArrayObject* get_values() const;
+
+    /**
+     * Get [key, value] pairs with low <= key < high, in key order
+     */
+    ArrayObject* range(const Object& low, const Object& high) const;
+
+    /**
+     * Call f(key, value) on each entry, in key order
+     */
+    template <class F>
+    void for_each(F f) const
+    {
+        if (root_ != nullptr) {
+            for_each(*root_, f);
+        }
+    }
+
+    /**
+     * Compare two ordered maps
+     */
+    bool eq(const OrderedMapObject& map) const;
+
+    void gc_visit(gc::Visitor& visitor) override;
+
+    BaseObject* move_to(void* slot) override;
+
+    size_t external_size() const override;
+
+    // B-tree minimum degree: nodes other than root hold between
+    // MIN_DEGREE - 1 and MAX_KEYS keys
+    static const size_t MIN_DEGREE = 16;
+    static const size_t MAX_KEYS = 2 * MIN_DEGREE - 1;
+
+private:
+    OrderedMapObject(const OrderedMapObject&) = delete;
+    OrderedMapObject& operator=(const OrderedMapObject&) = delete;
+
+    OrderedMapObject(OrderedMapObject&& map);
+
+    struct Node
+    {
+        std::vector<Object> keys;
+        std::vector<Object> values;
+        std::vector<Node*> children; // Empty for leaves
+
+        bool leaf() const
+        {
+            return children.empty();
+        }
+
+        bool full() const
+        {
+            return keys.size() == MAX_KEYS;
+        }
+    };
+
+    template <class F>
+    static void for_each(const Node& node, F& f)
+    {
+        for (size_t i = 0; i < node.keys.size(); ++i) {
+            if (!node.leaf()) {
+                for_each(*node.children[i], f);
+            }
+            f(node.keys[i], node.values[i]);
+        }
+        if (!node.leaf()) {
+            for_each(*node.children.back(), f);
+        }
+    }
+
+    /**
+     * Throw TypeError if key can't be compared to the keys in the map
+     */
+    void check_key(const Object& key) const;
+
+    /**
+     * Get position of first key not less than key in a node
+     */
+    static size_t search(const Node& node, const Object& key);
+
+    /**
+     * Check if key at position in node is equal to key (see search)
+     */
+    static bool matches(const Node& node, size_t position, const Object& key);
+
+    /**
+     * Split full child at position, its median key moves up to node
+     */
+    static void split_child(Node& node, size_t position);
+
+    /**
+     * Merge child at position + 1 and the key between them into child at position
+     */
+    static void merge_children(Node& node, size_t position);
+
+    /**
+     * Ensure child at position holds at least MIN_DEGREE keys, before
+     * descending into it
+     * @return position of child holding the same keys range
+     */
+    static size_t fill_child(Node& node, size_t position);
+
+    static bool remove(Node& node, const Object& key);
+
+    /**
+     * Append entries in range to result
+     * @return false once a key greater than or equal to high has been found
+     */
+    static bool range(const Node& node, const Object& low, const Object& high, ArrayObject& result);
+
+    static void gc_visit(Node& node, gc::Visitor& visitor);
+
+    static size_t external_size(const Node& node);
+
+    static void destroy(Node* node);
+
+    Node* root_;
+    size_t size_;
+};
+
+#endif
@@ -3,6 +3,7 @@
 #include "Error.hpp"
 #include "Operators.hpp"
 #include "ast/Node.hpp"
+#include "gc/Profiler.hpp"
 
 #include <iostream>
 #include <iomanip>
@@ -85,7 +86,9 @@ ast::Node* Parser::null_denotation(const Token& token)
 
         case Token::ARRAY_LITERAL:
         {
-            ast::ArrayExprNode* node = new ast::ArrayExprNode();
+            ast::ArrayExprNode* node = new ast::ArrayExprNode(
+                gc::Profiler::register_site("array literal", token.line)
+            );
             if (tokens_[index_].get_type() != Token::RIGHT_BRACKET) {
                 while (true) {
                     node->add_value(parse(0));
@@ -101,7 +104,9 @@ ast::Node* Parser::null_denotation(const Token& token)
 
         case Token::MAP_LITERAL:
         {
-            ast::HashmapExprNode* node = new ast::HashmapExprNode();
+            ast::HashmapExprNode* node = new ast::HashmapExprNode(
+                gc::Profiler::register_site("hashmap literal", token.line)
+            );
             if (tokens_[index_].get_type() != Token::RIGHT_BRACE) {
                 while (true) {
                     const ast::Node* key = parse(0);
@@ -186,7 +191,12 @@ ast::Node* Parser::left_denotation(const Token& token, const ast::Node* left)
     if (token.get_type() == Token::OPERATOR) {
         Operator op = token.get_operator();
         if (op == Operator::OP_FUNC_CALL) {
-            ast::FuncCallNode* node = new ast::FuncCallNode(left);
+            // Name the allocation site after the function, if called by name
+            const Token& callee = tokens_[index_ - 2];
+            ast::FuncCallNode* node = new ast::FuncCallNode(left, gc::Profiler::register_site(
+                callee.get_type() == Token::IDENTIFIER ? SymbolTable::get_name(callee.get_id_hash()) + "()" : "call",
+                token.line
+            ));
             // Find arguments until matching right parenthesis
             if (tokens_[index_].get_type() != Token::RIGHT_PAREN) {
                 while (true) {
@@ -201,13 +211,34 @@ ast::Node* Parser::left_denotation(const Token& token, const ast::Node* left)
             return node;
         }
         else if (op == Operator::OP_INDEX) {
-            ast::Node* right = parse(0);
+            // Constant string key: lookups in hashmaps are cached
+            if (tokens_[index_].get_type() == Token::VALUE
+                && tokens_[index_].get_object().get_type() == Object::STRING
+                && index_ + 1 < tokens_.size() && tokens_[index_ + 1].get_type() == Token::RIGHT_BRACKET) {
+                const Object& key = tokens_[index_].get_object();
+                index_ += 2;
+                if (assignment_follows()) {
+                    return parse_element_assignment(left, new ast::ValueNode(key));
+                }
+                return new ast::KeyLookupNode(left, key);
+            }
+            // Slice bounds are optional: a[start:end], a[start:], a[:end]
+            ast::Node* right = tokens_[index_].get_type() != Token::COLON ? parse(0) : nullptr;
+            if (tokens_[index_].get_type() == Token::COLON) {
+                advance(Token::COLON);
+                ast::Node* end = tokens_[index_].get_type() != Token::RIGHT_BRACKET ? parse(0) : nullptr;
+                advance(Token::RIGHT_BRACKET);
+                return new ast::SliceNode(left, right, end, gc::Profiler::register_site("slice", token.line));
+            }
             advance(Token::RIGHT_BRACKET);
-            return new ast::BinaryOpNode(Operator::OP_INDEX, left, right);
+            if (assignment_follows()) {
+                return parse_element_assignment(left, right);
+            }
+            return new ast::BinaryOpNode(Operator::OP_INDEX, left, right, 0);
         }
         else {
             ast::Node* right = parse(Operators::is_right_associative(op) ? token.lbp - 1 : token.lbp);
-            return new ast::BinaryOpNode(op, left, right);
+            return new ast::BinaryOpNode(op, left, right, register_operator_site(token));
         }
     }
     else {
@@ -215,6 +246,31 @@ ast::Node* Parser::left_denotation(const Token& token, const ast::Node* left)
     }
 }
 
+bool Parser::assignment_follows() const
+{
+    const Token& token = tokens_[index_];
+    return token.get_type() == Token::OPERATOR && Operators::is_assignment(token.get_operator());
+}
+
+ast::Node* Parser::parse_element_assignment(const ast::Node* target, const ast::Node* index)
+{
+    const Token& token = tokens_[index_++];
+    // Assignment operators are right associative: a[i] = b[j] = x
+    ast::Node* value = parse(token.lbp - 1);
+    return new ast::ElementAssignNode(token.get_operator(), target, index, value, register_operator_site(token));
+}
+
+uint32_t Parser::register_operator_site(const Token& token) const
+{
+    // Concatenation and repetition create new strings and arrays
+    Operator op = token.get_operator();
+    if (op == Operator::OP_ADDITION || op == Operator::OP_MULTIPLICATION
+        || op == Operator::OP_ADD_AND_ASSIGN || op == Operator::OP_MULTIPLY_AND_ASSIGN) {
+        return gc::Profiler::register_site(std::string("operator ") + Operators::to_str(op), token.line);
+    }
+    return 0;
+}
+
 void Parser::advance(Token::Type type)
 {
     if (index_ >= tokens_.size()) {
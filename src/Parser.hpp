@@ -75,6 +75,22 @@ private:
      */
     ast::Node* left_denotation(const Token& current, const ast::Node* left);
 
+    /**
+     * Check if current token is an assignment operator (=, +=, ...)
+     */
+    bool assignment_follows() const;
+
+    /**
+     * Parse an assignment to target[index], from its assignment operator
+     */
+    ast::Node* parse_element_assignment(const ast::Node* target, const ast::Node* index);
+
+    /**
+     * Register the allocation site of a binary operator (see gc::Profiler)
+     * @return site ID, 0 if the operator doesn't allocate
+     */
+    uint32_t register_operator_site(const Token& token) const;
+
     Scanner scanner_;
     const std::vector<Token>& tokens_;
     ast::Tree ast_;
@@ -0,0 +1,152 @@
+#include "PriorityQueueObject.hpp"
+#include "Error.hpp"
+
+#include <algorithm>
+#include <new>
+
+
+PriorityQueueObject::PriorityQueueObject(bool max_first):
+    BaseObject(),
+    sequence_(0),
+    max_first_(max_first)
+{
+}
+
+PriorityQueueObject::PriorityQueueObject(PriorityQueueObject&& queue):
+    BaseObject(queue),
+    heap_(std::move(queue.heap_)),
+    sequence_(queue.sequence_),
+    max_first_(queue.max_first_)
+{
+}
+
+PriorityQueueObject::~PriorityQueueObject()
+{
+}
+
+const char* PriorityQueueObject::class_name() const
+{
+    return "pqueue";
+}
+
+size_t PriorityQueueObject::size() const
+{
+    return heap_.size();
+}
+
+bool PriorityQueueObject::before(const Entry& a, const Entry& b) const
+{
+    if (max_first_ ? b.key.less_than(a.key) : a.key.less_than(b.key)) {
+        return true;
+    }
+    if (max_first_ ? a.key.less_than(b.key) : b.key.less_than(a.key)) {
+        return false;
+    }
+    return a.sequence < b.sequence;
+}
+
+void PriorityQueueObject::sift_up(size_t position)
+{
+    while (position > 0) {
+        size_t parent = (position - 1) / 2;
+        if (!before(heap_[position], heap_[parent])) {
+            break;
+        }
+        std::swap(heap_[position], heap_[parent]);
+        position = parent;
+    }
+}
+
+void PriorityQueueObject::sift_down(size_t position)
+{
+    for (;;) {
+        size_t first = position;
+        size_t left = 2 * position + 1;
+        size_t right = left + 1;
+        if (left < heap_.size() && before(heap_[left], heap_[first])) {
+            first = left;
+        }
+        if (right < heap_.size() && before(heap_[right], heap_[first])) {
+            first = right;
+        }
+        if (first == position) {
+            break;
+        }
+        std::swap(heap_[position], heap_[first]);
+        position = first;
+    }
+}
+
+void PriorityQueueObject::push(const Object& value, const Object& key)
+{
+    // get_value() ensures identifier references aren't stored in the queue
+    Entry entry{key.get_value(), value.get_value(), sequence_++};
+    if (!heap_.empty()) {
+        // Compare with the top before inserting: keys which can't be compared
+        // throw before the heap is modified
+        entry.key.less_than(heap_.front().key);
+    }
+    heap_.push_back(std::move(entry));
+    sift_up(heap_.size() - 1);
+}
+
+void PriorityQueueObject::check_not_empty() const
+{
+    if (heap_.empty()) {
+        throw Error::ValueError("priority queue is empty");
+    }
+}
+
+Object PriorityQueueObject::pop()
+{
+    check_not_empty();
+    Object value = std::move(heap_.front().value);
+    std::swap(heap_.front(), heap_.back());
+    heap_.pop_back();
+    if (!heap_.empty()) {
+        sift_down(0);
+    }
+    return value;
+}
+
+const Object& PriorityQueueObject::peek() const
+{
+    check_not_empty();
+    return heap_.front().value;
+}
+
+std::vector<Object> PriorityQueueObject::sorted_values() const
+{
+    std::vector<const Entry*> entries;
+    entries.reserve(heap_.size());
+    for (const auto& entry: heap_) {
+        entries.push_back(&entry);
+    }
+    std::sort(entries.begin(), entries.end(), [this](const Entry* a, const Entry* b) {
+        return before(*a, *b);
+    });
+    std::vector<Object> values;
+    values.reserve(entries.size());
+    for (const Entry* entry: entries) {
+        values.push_back(entry->value);
+    }
+    return values;
+}
+
+void PriorityQueueObject::gc_visit(gc::Visitor& visitor)
+{
+    for (auto& entry: heap_) {
+        entry.key.gc_visit(visitor);
+        entry.value.gc_visit(visitor);
+    }
+}
+
+BaseObject* PriorityQueueObject::move_to(void* slot)
+{
+    return ::new (slot) PriorityQueueObject(std::move(*this));
+}
+
+size_t PriorityQueueObject::external_size() const
+{
+    return heap_.capacity() * sizeof(Entry);
+}
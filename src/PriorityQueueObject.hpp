@@ -0,0 +1,87 @@
+#ifndef ASPIC_PRIORITY_QUEUE_OBJECT_HPP
+#define ASPIC_PRIORITY_QUEUE_OBJECT_HPP
+
+#include "BaseObject.hpp"
+#include "Object.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * A priority queue, implemented as a binary heap
+ *
+ * Each value is pushed with a key (the value itself by default), keys are
+ * compared with the < operator. Values with equal keys are popped in
+ * insertion order.
+ */
+class PriorityQueueObject: public BaseObject
+{
+public:
+    /**
+     * @param max_first: pop largest key first, instead of smallest
+     */
+    explicit PriorityQueueObject(bool max_first);
+    ~PriorityQueueObject();
+
+    const char* class_name() const override;
+
+    size_t size() const;
+
+    /**
+     * Insert a value
+     * Throw UnsupportedBinaryOperator if key can't be compared to the others
+     */
+    void push(const Object& value, const Object& key);
+
+    /**
+     * Remove and return the value with the first key
+     * Throw ValueError if queue is empty
+     */
+    Object pop();
+
+    /**
+     * Get the value with the first key
+     * Throw ValueError if queue is empty
+     */
+    const Object& peek() const;
+
+    /**
+     * Get values, sorted in pop order
+     */
+    std::vector<Object> sorted_values() const;
+
+    void gc_visit(gc::Visitor& visitor) override;
+
+    BaseObject* move_to(void* slot) override;
+
+    size_t external_size() const override;
+
+private:
+    PriorityQueueObject(const PriorityQueueObject&) = delete;
+    PriorityQueueObject& operator=(const PriorityQueueObject&) = delete;
+
+    PriorityQueueObject(PriorityQueueObject&& queue);
+
+    struct Entry
+    {
+        Object key;
+        Object value;
+        uint64_t sequence;
+    };
+
+    /**
+     * Check if entry a must be popped before entry b
+     */
+    bool before(const Entry& a, const Entry& b) const;
+
+    void sift_up(size_t position);
+    void sift_down(size_t position);
+
+    void check_not_empty() const;
+
+    std::vector<Entry> heap_;
+    uint64_t sequence_;
+    bool max_first_;
+};
+
+#endif
@@ -8,7 +8,8 @@
 
 Scanner::Scanner():
     opened_pairs_(0),
-    opened_blocks_(0)
+    opened_blocks_(0),
+    line_(0)
 {
     // Define mapping for operator symbols
     // Multi-part operators () and [] are scanned separately in the tokenize method
@@ -44,6 +45,8 @@ bool Scanner::tokenize(const std::string& line)
     static std::string buffer;
 
     const Token* previous = nullptr;
+    size_t first_token = tokens_.size();
+    ++line_;
     for (size_t i = 0; i < line.size(); ++i) {
         char current = line[i];
 
@@ -247,13 +250,19 @@ bool Scanner::tokenize(const std::string& line)
     }
 
     // Each expression must end with special END_EXPR token
+    bool complete = false;
     if (tokens_.size() > 0) {
         if (opened_pairs_ == 0 && tokens_.back().end_of_expression()) {
             tokens_.push_back(Token(Token::END_EXPR));
-            return opened_blocks_ == 0;
+            complete = opened_blocks_ == 0;
         }
     }
-    return false;
+
+    // Tag tokens with their source line
+    for (size_t i = first_token; i < tokens_.size(); ++i) {
+        tokens_[i].line = line_;
+    }
+    return complete;
 }
 
 void Scanner::clear()
@@ -261,6 +270,7 @@ void Scanner::clear()
     tokens_.clear();
     opened_pairs_ = 0;
     opened_blocks_ = 0;
+    line_ = 0;
 }
 
 const std::vector<Token>& Scanner::get_tokens() const
@@ -309,11 +319,15 @@ bool Scanner::precedes_unary_operator(const Token* previous) const
     /* "+" and "-" are unary operator if they are:
         - preceded by nothing
         - preceded by another operator
-        - preceded by a left bracket
+        - preceded by a left parenthesis, bracket or brace
         - preceded by an argument separator
+        - preceded by a colon (hashmap value, slice bound)
     */
     return previous == nullptr
         || previous->get_type() == Token::OPERATOR
         || previous->get_type() == Token::LEFT_PAREN
-        || previous->get_type() == Token::ARG_SEPARATOR;
+        || previous->get_type() == Token::ARRAY_LITERAL
+        || previous->get_type() == Token::MAP_LITERAL
+        || previous->get_type() == Token::ARG_SEPARATOR
+        || previous->get_type() == Token::COLON;
 }
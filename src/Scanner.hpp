@@ -25,7 +25,7 @@ public:
     bool tokenize(const std::string& line);
 
     /**
-     * Clear all tokens
+     * Clear all tokens, and reset line number
      */
     void clear();
 
@@ -66,6 +66,7 @@ private:
     std::vector<Token> tokens_;
     int opened_pairs_;
     int opened_blocks_;
+    int line_; // number of scanned lines
 };
 
 #endif
@@ -0,0 +1,177 @@
+#include "SetObject.hpp"
+#include "ArrayObject.hpp"
+
+#include <new>
+
+
+SetObject::SetObject():
+    BaseObject()
+{
+}
+
+SetObject::SetObject(SetObject&& set):
+    BaseObject(set),
+    entries_(std::move(set.entries_)),
+    index_(std::move(set.index_))
+{
+}
+
+SetObject::~SetObject()
+{
+}
+
+const char* SetObject::class_name() const
+{
+    return "set";
+}
+
+size_t SetObject::size() const
+{
+    return entries_.size();
+}
+
+const Object& SetObject::at(size_t position) const
+{
+    return entries_[position].value;
+}
+
+size_t SetObject::find(const Object& value, size_t hash) const
+{
+    return index_.find(hash, [&](uint32_t position) {
+        const Entry& entry = entries_[position];
+        return entry.hash == hash && entry.value == value;
+    });
+}
+
+void SetObject::insert(const Object& value, size_t hash)
+{
+    entries_.push_back(Entry{value, hash});
+    if (index_.full(entries_.size() - 1)) {
+        index_.rebuild(entries_.size(), [this](size_t position) {
+            return entries_[position].hash;
+        });
+    }
+    else {
+        index_.insert(hash, entries_.size() - 1);
+    }
+}
+
+bool SetObject::contains(const Object& value) const
+{
+    const Object& v = value.get_value();
+    return find(v, std::hash<Object>{}(v)) != HashIndex::NOT_FOUND;
+}
+
+bool SetObject::add(const Object& value)
+{
+    // get_value() ensures identifier references are resolved, for hashing and storage
+    const Object& v = value.get_value();
+    size_t hash = std::hash<Object>{}(v);
+    if (find(v, hash) != HashIndex::NOT_FOUND) {
+        return false;
+    }
+    insert(v, hash);
+    return true;
+}
+
+bool SetObject::remove(const Object& value)
+{
+    const Object& v = value.get_value();
+    size_t hash = std::hash<Object>{}(v);
+    size_t position = find(v, hash);
+    if (position == HashIndex::NOT_FOUND) {
+        return false;
+    }
+    index_.erase(hash, position);
+    // Fill the hole with the last entry
+    size_t last = entries_.size() - 1;
+    if (position != last) {
+        index_.move(entries_[last].hash, last, position);
+        entries_[position] = std::move(entries_[last]);
+    }
+    entries_.pop_back();
+    return true;
+}
+
+bool SetObject::eq(const SetObject& set) const
+{
+    if (this == &set) {
+        return true;
+    }
+    if (size() != set.size()) {
+        return false;
+    }
+    for (const Entry& entry: entries_) {
+        if (set.find(entry.value, entry.hash) == HashIndex::NOT_FOUND) {
+            return false;
+        }
+    }
+    return true;
+}
+
+SetObject* SetObject::set_union(const SetObject& a, const SetObject& b)
+{
+    SetObject* set = new SetObject();
+    set->entries_.reserve(a.size() + b.size());
+    for (const Entry& entry: a.entries_) {
+        set->insert(entry.value, entry.hash);
+    }
+    for (const Entry& entry: b.entries_) {
+        if (set->find(entry.value, entry.hash) == HashIndex::NOT_FOUND) {
+            set->insert(entry.value, entry.hash);
+        }
+    }
+    return set;
+}
+
+SetObject* SetObject::set_intersection(const SetObject& a, const SetObject& b)
+{
+    // Iterate over the smallest set, keeping the order of a if sizes are equal
+    const SetObject& small = b.size() < a.size() ? b : a;
+    const SetObject& large = b.size() < a.size() ? a : b;
+    SetObject* set = new SetObject();
+    for (const Entry& entry: small.entries_) {
+        if (large.find(entry.value, entry.hash) != HashIndex::NOT_FOUND) {
+            set->insert(entry.value, entry.hash);
+        }
+    }
+    return set;
+}
+
+SetObject* SetObject::set_difference(const SetObject& a, const SetObject& b)
+{
+    SetObject* set = new SetObject();
+    for (const Entry& entry: a.entries_) {
+        if (b.find(entry.value, entry.hash) == HashIndex::NOT_FOUND) {
+            set->insert(entry.value, entry.hash);
+        }
+    }
+    return set;
+}
+
+ArrayObject* SetObject::to_array() const
+{
+    ArrayObject* array = new ArrayObject(entries_.size());
+    for (const Entry& entry: entries_) {
+        array->push(entry.value);
+    }
+    return array;
+}
+
+BaseObject* SetObject::move_to(void* slot)
+{
+    return ::new (slot) SetObject(std::move(*this));
+}
+
+size_t SetObject::external_size() const
+{
+    return entries_.capacity() * sizeof(Entry) + index_.memory();
+}
+
+void SetObject::gc_visit(gc::Visitor& visitor)
+{
+    // Values are hashable, only frozen arrays are shared objects
+    for (Entry& entry: entries_) {
+        entry.value.gc_visit(visitor);
+    }
+}
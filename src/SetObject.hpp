@@ -0,0 +1,103 @@
+#ifndef ASPIC_SET_OBJECT_HPP
+#define ASPIC_SET_OBJECT_HPP
+
+#include "BaseObject.hpp"
+#include "Object.hpp"
+#include "HashIndex.hpp"
+
+#include <vector>
+
+class ArrayObject;
+
+/**
+ * A set of hashable values
+ *
+ * Values are stored in a dense vector with their hash, indexed by a
+ * HashIndex. Values are iterated in insertion order, except that removing a
+ * value moves the last one to its position.
+ */
+class SetObject: public BaseObject
+{
+public:
+    SetObject();
+    ~SetObject();
+
+    const char* class_name() const override;
+
+    /**
+     * Get number of values
+     */
+    size_t size() const;
+
+    /**
+     * Get value at given position
+     */
+    const Object& at(size_t position) const;
+
+    /**
+     * Check if set holds a value
+     */
+    bool contains(const Object& value) const;
+
+    /**
+     * Add a value
+     * @return false if value was already in the set
+     */
+    bool add(const Object& value);
+
+    /**
+     * Remove a value
+     * @return false if value wasn't in the set
+     */
+    bool remove(const Object& value);
+
+    /**
+     * Compare two sets
+     */
+    bool eq(const SetObject& set) const;
+
+    /**
+     * Create a new set from two sets
+     */
+    static SetObject* set_union(const SetObject& a, const SetObject& b);
+    static SetObject* set_intersection(const SetObject& a, const SetObject& b);
+    static SetObject* set_difference(const SetObject& a, const SetObject& b);
+
+    /**
+     * Get values as an array
+     */
+    ArrayObject* to_array() const;
+
+    void gc_visit(gc::Visitor& visitor) override;
+
+    BaseObject* move_to(void* slot) override;
+
+    size_t external_size() const override;
+
+private:
+    SetObject(const SetObject&) = delete;
+    SetObject& operator=(const SetObject&) = delete;
+
+    SetObject(SetObject&& set);
+
+    struct Entry
+    {
+        Object value;
+        size_t hash;
+    };
+
+    /**
+     * Get position of value, or HashIndex::NOT_FOUND
+     */
+    size_t find(const Object& value, size_t hash) const;
+
+    /**
+     * Add a value known to be missing
+     */
+    void insert(const Object& value, size_t hash);
+
+    std::vector<Entry> entries_;
+    HashIndex index_;
+};
+
+#endif
@@ -0,0 +1,56 @@
+#include "Shape.hpp"
+
+// Init static attributes
+size_t Shape::count_ = 0;
+
+
+Shape::Shape()
+{
+    ++count_;
+}
+
+Shape* Shape::root()
+{
+    // Never destroyed: hashmaps may still reference shapes at exit
+    static Shape* root = new Shape();
+    return root;
+}
+
+Shape* Shape::add(const Object& key)
+{
+    auto it = transitions_.find(key);
+    if (it != transitions_.end()) {
+        return it->second;
+    }
+    if (keys_.size() >= MAX_KEYS || count_ >= MAX_SHAPES) {
+        return nullptr;
+    }
+    Shape* child = new Shape();
+    child->keys_.reserve(keys_.size() + 1);
+    child->keys_ = keys_;
+    child->keys_.push_back(key);
+    transitions_.emplace(key, child);
+    return child;
+}
+
+size_t Shape::find(const Object& key) const
+{
+    // Few keys: a linear search on cached hashes beats a hash table
+    size_t hash = key.string_hash();
+    for (size_t i = 0; i < keys_.size(); ++i) {
+        if (keys_[i].string_hash() == hash && keys_[i].get_string() == key.get_string()) {
+            return i;
+        }
+    }
+    return NOT_FOUND;
+}
+
+size_t Shape::size() const
+{
+    return keys_.size();
+}
+
+const Object& Shape::key_at(size_t offset) const
+{
+    return keys_[offset];
+}
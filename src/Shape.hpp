@@ -0,0 +1,66 @@
+#ifndef ASPIC_SHAPE_HPP
+#define ASPIC_SHAPE_HPP
+
+#include "Object.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Ordered list of string keys, shared by hashmaps built with the same keys
+ * in the same order (hidden class). Such hashmaps only store a flat vector
+ * of values, at the offset of their key in the shape.
+ *
+ * Shapes form a tree rooted at the empty shape: adding a key to a shape
+ * leads to the same child shape for all hashmaps. Shapes live as long as
+ * the process, their number and size are bounded.
+ */
+class Shape
+{
+public:
+    /**
+     * Get the shape without keys
+     */
+    static Shape* root();
+
+    /**
+     * Get shape with keys of this shape, followed by key
+     * @return child shape, or nullptr if the limits are reached
+     */
+    Shape* add(const Object& key);
+
+    /**
+     * Get offset of a key, or NOT_FOUND
+     */
+    size_t find(const Object& key) const;
+
+    /**
+     * Get number of keys
+     */
+    size_t size() const;
+
+    /**
+     * Get key at given offset
+     */
+    const Object& key_at(size_t offset) const;
+
+    static const size_t NOT_FOUND = SIZE_MAX;
+
+    // Limits: keys in a shape, and total number of shapes
+    static const size_t MAX_KEYS = 32;
+    static const size_t MAX_SHAPES = 8192;
+
+private:
+    Shape();
+    Shape(const Shape&) = delete;
+    Shape& operator=(const Shape&) = delete;
+
+    std::vector<Object> keys_;
+    std::unordered_map<Object, Shape*> transitions_;
+
+    static size_t count_;
+};
+
+#endif
@@ -6,6 +6,8 @@
 #include "Parser.hpp"
 #include "Error.hpp"
 #include "SymbolTable.hpp"
+#include "Metrics.hpp"
+#include "gc/Profiler.hpp"
 
 
 void Shell::run()
@@ -17,6 +19,11 @@ void Shell::run()
     std::cout << " * scanner: print list of scanned tokens" << std::endl;
     std::cout << " * pool:    print list of entries in symbol table"  << std::endl;
     std::cout << " * ast:     print abstract syntax tree of last expression" << std::endl;
+    std::cout << " * mem:     print list of allocated objects and heap usage" << std::endl;
+    std::cout << " * gc:      run garbage collector" << std::endl;
+    std::cout << " * compact: run garbage collector, then compact heap" << std::endl;
+    std::cout << " * stats:   print runtime counters" << std::endl;
+    std::cout << " * profile: print heap usage per allocation site (see --heap-profile)" << std::endl;
 
     // Configure readline to insert tabs (instead of PATH completion)
     rl_bind_key('\t', rl_insert);
@@ -49,6 +56,15 @@ void Shell::run()
         else if (input == "gc") {
             SymbolTable::mark_and_sweep();
         }
+        else if (input == "compact") {
+            SymbolTable::compact_memory();
+        }
+        else if (input == "stats") {
+            Metrics::write_openmetrics(std::cout);
+        }
+        else if (input == "profile") {
+            gc::Profiler::report(std::cout);
+        }
         else {
             // Do not reset parser if user if typing a block
             if (full_statement) {
@@ -1,23 +1,34 @@
 #include "SymbolTable.hpp"
 #include "Error.hpp"
+#include "Hash.hpp"
 #include "BaseObject.hpp"
+#include "Metrics.hpp"
+#include "gc/Heap.hpp"
+#include "gc/Marker.hpp"
+#include "gc/RefCount.hpp"
+#include "functions/LibArray.hpp"
 #include "functions/LibCore.hpp"
+#include "functions/LibSet.hpp"
+#include "functions/LibQueue.hpp"
+#include "functions/LibOrdMap.hpp"
+#include "functions/LibBitset.hpp"
+#include "functions/LibVector.hpp"
+#include "functions/LibLru.hpp"
+#include "functions/LibSketch.hpp"
 #include "functions/LibString.hpp"
 #include "functions/LibTypes.hpp"
 
 #include <iostream>
 #include <iomanip>
-#include <functional>
 
 // Init static attributes
 SymbolTable::IdentifierTable SymbolTable::identifiers_;
 SymbolTable::NameTable       SymbolTable::names_;
-SymbolTable::ObjectList      SymbolTable::shared_objects_;
 
 
 size_t SymbolTable::hash_identifier_name(const std::string& name)
 {
-    size_t hash = std::hash<std::string>{}(name);
+    size_t hash = Hash::bytes(name.data(), name.size());
     names_.emplace(hash, name);
     return hash;
 }
@@ -40,10 +51,93 @@ void SymbolTable::register_stdlib()
     add("count", array_count);
     add("find", array_find);
     add("push", array_push);
+    add("freeze", array_freeze);
+    add("is_frozen", array_is_frozen);
     add("hpush", hash_push);
     add("keys", hash_keys);
     add("len", core_len);
+    add("slice", core_slice);
     add("rand", core_rand);
+    add("runtime_stats", core_runtime_stats);
+    add("heap_profile", core_heap_profile);
+
+    // Load array library
+    add("sum", array_sum);
+    add("mean", array_mean);
+    add("argmin", array_argmin);
+    add("argmax", array_argmax);
+
+    // Load set library
+    add("set", set_create);
+    add("set_add", set_add);
+    add("set_remove", set_remove);
+    add("set_has", set_has);
+    add("set_values", set_values);
+    add("set_union", set_union);
+    add("set_intersection", set_intersection);
+    add("set_difference", set_difference);
+
+    // Load queue library
+    add("deque", deque_create);
+    add("push_front", deque_push_front);
+    add("push_back", deque_push_back);
+    add("pop_front", deque_pop_front);
+    add("pop_back", deque_pop_back);
+    add("peek_front", deque_peek_front);
+    add("peek_back", deque_peek_back);
+    add("pqueue", pqueue_create);
+    add("pq_push", pqueue_push);
+    add("pq_pop", pqueue_pop);
+    add("pq_peek", pqueue_peek);
+
+    // Load ordered map library
+    add("ordmap", ordmap_create);
+    add("om_set", ordmap_set);
+    add("om_has", ordmap_has);
+    add("om_remove", ordmap_remove);
+    add("om_min", ordmap_min);
+    add("om_max", ordmap_max);
+    add("om_lower_bound", ordmap_lower_bound);
+    add("om_range", ordmap_range);
+    add("om_values", ordmap_values);
+
+    // Load bitset library
+    add("bitset", bitset_create);
+    add("bs_set", bitset_set);
+    add("bs_clear", bitset_clear);
+    add("bs_test", bitset_test);
+    add("bs_count", bitset_count);
+    add("bs_indexes", bitset_indexes);
+    add("bs_and", bitset_and);
+    add("bs_or", bitset_or);
+    add("bs_xor", bitset_xor);
+    add("bs_andnot", bitset_andnot);
+
+    // Load vector library
+    add("vector", vector_create);
+    add("vec_values", vector_values);
+
+    // Load lru library
+    add("lru", lru_create);
+    add("lru_get", lru_get);
+    add("lru_put", lru_put);
+    add("lru_has", lru_has);
+    add("lru_remove", lru_remove);
+    add("lru_stats", lru_stats);
+
+    // Load sketch library
+    add("bloom", bloom_create);
+    add("bloom_add", bloom_add);
+    add("bloom_has", bloom_has);
+    add("bloom_merge", bloom_merge);
+    add("hll", hll_create);
+    add("hll_add", hll_add);
+    add("hll_count", hll_count);
+    add("hll_merge", hll_merge);
+    add("cms", cms_create);
+    add("cms_add", cms_add);
+    add("cms_count", cms_count);
+    add("cms_merge", cms_merge);
 
     // Load string library
     add("str_len", str_len);
@@ -77,6 +171,7 @@ void SymbolTable::add(const std::string& name, const FunctionWrapper& function)
 {
     size_t hash = hash_identifier_name(name);
     identifiers_.emplace(hash, Object::create_function(function));
+    Metrics::register_builtin(name, function);
 }
 
 void SymbolTable::inspect_symbols()
@@ -99,35 +194,63 @@ void SymbolTable::inspect_symbols()
 
 void SymbolTable::inspect_memory()
 {
-    for (ObjectList::const_iterator it = shared_objects_.begin(); it != shared_objects_.end(); ++it) {
-        std::cout << (**it).class_name() << "@" <<  *it << std::endl;
-    }
+    gc::Heap::finish_sweep();
+    gc::Heap::for_each_object([](const BaseObject* object) {
+        std::cout << object->class_name() << "@" << object << std::endl;
+    });
+    print_heap_stats();
 }
 
-void SymbolTable::track_object(BaseObject* ptr)
+void SymbolTable::print_heap_stats()
 {
-    shared_objects_.push_back(ptr);
+    gc::Heap::Stats stats = gc::Heap::get_stats();
+    std::cout << "Heap: " << stats.object_count << " objects in "
+        << stats.page_count << " pages (" << stats.page_bytes / 1024 << " KiB), fragmentation: "
+        << std::fixed << std::setprecision(1) << stats.fragmentation() * 100 << "%"
+        << std::defaultfloat << std::endl;
 }
 
-void SymbolTable::mark_and_sweep()
+void SymbolTable::compact_memory()
+{
+    mark_and_sweep();
+    gc::Heap::finish_sweep();
+    std::cout << "Before compaction: ";
+    print_heap_stats();
+
+    std::vector<Object*> roots = get_roots();
+    gc::Heap::compact(roots);
+    std::cout << "After compaction:  ";
+    print_heap_stats();
+}
+
+std::vector<Object*> SymbolTable::get_roots()
 {
-    // Visit all objects associated to an identifier
+    std::vector<Object*> roots;
+    roots.reserve(identifiers_.size());
     for (auto& kv: identifiers_) {
-        kv.second.gc_visit();
+        roots.push_back(&kv.second);
     }
+    return roots;
+}
 
-    ObjectList::iterator it = shared_objects_.begin();
-    while (it != shared_objects_.end())  {
-        // Unmark visited objects, remove the other ones
-        if ((**it).is_marked()) {
-            (**it).clear_mark();
-            ++it;
-        }
-        else {
-            delete *it;
-            it = shared_objects_.erase(it);
-        }
+void SymbolTable::mark_and_sweep()
+{
+    if (gc::RefCount::enabled()) {
+        // Acyclic garbage is already freed, only cycles are left
+        gc::RefCount::collect_cycles();
+        return;
     }
+
+    // Previous sweep must be complete before marks are set again
+    Metrics::Clock::time_point start = Metrics::Clock::now();
+    gc::Heap::finish_sweep();
+
+    // Mark all objects reachable from an identifier
+    gc::Marker::mark_from_roots(get_roots());
+
+    // Delete unmarked objects in the background, and reset marks on the other ones
+    gc::Heap::sweep();
+    Metrics::record_gc(Metrics::Clock::now() - start);
 }
 
 void SymbolTable::destroy()
@@ -136,6 +259,12 @@ void SymbolTable::destroy()
     // Clear all identifiers first, so the mark_and_sweep method won't
     // mark any objects. This ensures all allocated objects will be deleted.
     identifiers_.clear();
+    if (gc::RefCount::enabled()) {
+        // Free cycles, then stop counting so the final sweep reclaims
+        // leftovers without touching references between dead objects
+        gc::RefCount::collect_cycles();
+        gc::RefCount::disable();
+    }
     mark_and_sweep();
-    shared_objects_.clear();
+    gc::Heap::shutdown();
 }
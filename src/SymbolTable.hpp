@@ -6,9 +6,7 @@
 
 #include <string>
 #include <unordered_map>
-#include <list>
-
-class BaseObject;
+#include <vector>
 
 /**
  * The symbol table stores all declared identifiers, such as variables and
@@ -21,10 +19,9 @@ class BaseObject;
  * Built-in functions are automatically loaded in the symbol table when the
  * interpreter is started (see register_stdlib)
  *
- * The symbol table also stores shared objects which are passed by reference,
- * such as ArrayObject. A shared object is defined by:
- *   1. at least one identifier entry (identifiers_)
- *   2. a pointer to the allocated object (shared_objects_)
+ * Identifiers are the roots of the garbage collector: shared objects which are
+ * passed by reference, such as ArrayObject, are allocated in gc::Heap and
+ * stay alive as long as they can be reached from an identifier entry.
  */
 class SymbolTable
 {
@@ -69,9 +66,11 @@ public:
     static void inspect_memory();
 
     /**
-     * Add object to the list of allocated objects
+     * Collect garbage, then move live objects out of sparse heap pages so
+     * they can be released. Heap fragmentation is printed before and after.
+     * Must not be called while an expression is being evaluated.
      */
-    static void track_object(BaseObject* ptr);
+    static void compact_memory();
 
     /**
      * Mark and sweep garbage collection: visit all objects and delete the
@@ -91,14 +90,21 @@ private:
      */
     static void add(const std::string& name, const FunctionWrapper& function);
 
+    /**
+     * Print heap usage summary to stdout
+     */
+    static void print_heap_stats();
+
+    /**
+     * Get pointers to all identifier values (roots of the garbage collector)
+     */
+    static std::vector<Object*> get_roots();
+
     typedef std::unordered_map<size_t, Object> IdentifierTable;
     static IdentifierTable identifiers_;
 
     typedef std::unordered_map<size_t, std::string> NameTable;
     static NameTable names_;
-
-    typedef std::list<BaseObject*> ObjectList;
-    static ObjectList shared_objects_;
 };
 
 #endif
@@ -13,12 +13,14 @@ Token::Type Token::get_type() const
 
 Token::Token(Type type):
     lbp(0),
+    line(0),
     type_(type)
 {
 }
 
 Token::Token(const Object& object):
     lbp(0),
+    line(0),
     object_(object),
     type_(VALUE)
 {
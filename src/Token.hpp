@@ -73,6 +73,7 @@ public:
     bool end_of_expression() const;
 
     int lbp;
+    int line; // source line number, set by Scanner
 
 private:
     Token(const Object& object);
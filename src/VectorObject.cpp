@@ -0,0 +1,506 @@
+#include "VectorObject.hpp"
+#include "ArrayObject.hpp"
+#include "Error.hpp"
+
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <new>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define ASPIC_X86_SIMD
+#endif
+
+namespace {
+
+// Element-wise kernels
+// -----------------------------------------------------------------------------
+// Kernels are written once with GCC vector extensions, processing 32 bytes
+// of operands per step, and compiled twice: for the SSE2 baseline and for
+// AVX2 (selected at runtime if supported by the CPU).
+
+template <class T, size_t N>
+struct Lanes
+{
+    typedef T Type __attribute__((vector_size(N * sizeof(T))));
+};
+
+// Elements of a vector
+template <class T>
+struct Elements
+{
+    const T* data;
+
+    template <class V>
+    __attribute__((always_inline)) void load(size_t i, V& lanes) const
+    {
+        memcpy(&lanes, data + i, sizeof(lanes));
+    }
+
+    T at(size_t i) const
+    {
+        return data[i];
+    }
+};
+
+// A scalar, broadcast to each element
+template <class T>
+struct Broadcast
+{
+    T value;
+
+    template <class V>
+    __attribute__((always_inline)) void load(size_t, V& lanes) const
+    {
+        lanes = V{} + value;
+    }
+
+    T at(size_t) const
+    {
+        return value;
+    }
+};
+
+struct Add
+{
+    template <class V, class R>
+    static void lanes(const V& a, const V& b, R& result) { result = a + b; }
+
+    template <class T>
+    static T scalar(T a, T b) { return a + b; }
+};
+
+struct Subtract
+{
+    template <class V, class R>
+    static void lanes(const V& a, const V& b, R& result) { result = a - b; }
+
+    template <class T>
+    static T scalar(T a, T b) { return a - b; }
+};
+
+struct Multiply
+{
+    template <class V, class R>
+    static void lanes(const V& a, const V& b, R& result) { result = a * b; }
+
+    template <class T>
+    static T scalar(T a, T b) { return a * b; }
+};
+
+struct Divide
+{
+    template <class V, class R>
+    static void lanes(const V& a, const V& b, R& result) { result = a / b; }
+
+    template <class T>
+    static T scalar(T a, T b) { return a / b; }
+};
+
+// Comparison masks (-1 or 0 per lane) are converted to int 1 or 0
+struct Less
+{
+    template <class V, class R>
+    static void lanes(const V& a, const V& b, R& result) { result = -__builtin_convertvector(a < b, R); }
+
+    template <class T>
+    static int scalar(T a, T b) { return a < b; }
+};
+
+struct LessOrEqual
+{
+    template <class V, class R>
+    static void lanes(const V& a, const V& b, R& result) { result = -__builtin_convertvector(a <= b, R); }
+
+    template <class T>
+    static int scalar(T a, T b) { return a <= b; }
+};
+
+struct Greater
+{
+    template <class V, class R>
+    static void lanes(const V& a, const V& b, R& result) { result = -__builtin_convertvector(a > b, R); }
+
+    template <class T>
+    static int scalar(T a, T b) { return a > b; }
+};
+
+struct GreaterOrEqual
+{
+    template <class V, class R>
+    static void lanes(const V& a, const V& b, R& result) { result = -__builtin_convertvector(a >= b, R); }
+
+    template <class T>
+    static int scalar(T a, T b) { return a >= b; }
+};
+
+template <class Op, class T, class R, class Left, class Right>
+__attribute__((always_inline)) inline
+void map_lanes(R* result, const Left& left, const Right& right, size_t size)
+{
+    const size_t N = 32 / sizeof(T);
+    typedef typename Lanes<T, N>::Type V;
+    typedef typename Lanes<R, N>::Type RV;
+    size_t i = 0;
+    for (; i + N <= size; i += N) {
+        V a, b;
+        RV r;
+        left.load(i, a);
+        right.load(i, b);
+        Op::lanes(a, b, r);
+        memcpy(result + i, &r, sizeof(r));
+    }
+    for (; i < size; ++i) {
+        result[i] = Op::scalar(left.at(i), right.at(i));
+    }
+}
+
+template <class Op, class T, class R, class Left, class Right>
+void map_baseline(R* result, const Left& left, const Right& right, size_t size)
+{
+    map_lanes<Op, T>(result, left, right, size);
+}
+
+#ifdef ASPIC_X86_SIMD
+
+template <class Op, class T, class R, class Left, class Right>
+__attribute__((target("avx2")))
+void map_avx2(R* result, const Left& left, const Right& right, size_t size)
+{
+    map_lanes<Op, T>(result, left, right, size);
+}
+
+bool has_avx2()
+{
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+#endif
+
+template <class Op, class T, class R, class Left, class Right>
+void map(R* result, const Left& left, const Right& right, size_t size)
+{
+#ifdef ASPIC_X86_SIMD
+    if (has_avx2()) {
+        map_avx2<Op, T>(result, left, right, size);
+        return;
+    }
+#endif
+    map_baseline<Op, T>(result, left, right, size);
+}
+
+// Operands
+// -----------------------------------------------------------------------------
+
+/**
+ * A vector or a scalar operand, with elements of type T
+ */
+template <class T>
+struct Operand
+{
+    const T* data; // nullptr for a scalar
+    T value;
+
+    T at(size_t i) const
+    {
+        return data != nullptr ? data[i] : value;
+    }
+
+    bool has_zero(size_t size) const
+    {
+        if (data == nullptr) {
+            return value == 0;
+        }
+        for (size_t i = 0; i < size; ++i) {
+            if (data[i] == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+template <class Op, class T, class R>
+void map(R* result, const Operand<T>& left, const Operand<T>& right, size_t size)
+{
+    if (left.data != nullptr && right.data != nullptr) {
+        map<Op, T>(result, Elements<T>{left.data}, Elements<T>{right.data}, size);
+    }
+    else if (left.data != nullptr) {
+        map<Op, T>(result, Elements<T>{left.data}, Broadcast<T>{right.value}, size);
+    }
+    else {
+        map<Op, T>(result, Broadcast<T>{left.value}, Elements<T>{right.data}, size);
+    }
+}
+
+/**
+ * Apply a scalar function element-wise, for operators without a SIMD kernel
+ */
+template <class T, class R, class F>
+void map_scalar(R* result, const Operand<T>& left, const Operand<T>& right, size_t size, F f)
+{
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = f(left.at(i), right.at(i));
+    }
+}
+
+/**
+ * Throw if an int division fails: by zero, or INT_MIN by -1 (overflow)
+ */
+void check_divisors(const Operand<int>& dividend, const Operand<int>& divisor, size_t size)
+{
+    if (divisor.has_zero(size)) {
+        throw Error::DivideByZero();
+    }
+    if (divisor.data == nullptr && divisor.value != -1) {
+        return;
+    }
+    for (size_t i = 0; i < size; ++i) {
+        if (divisor.at(i) == -1 && dividend.at(i) == INT_MIN) {
+            throw Error::ValueError("integer division overflow");
+        }
+    }
+}
+
+/**
+ * Apply a comparison operator, result is an int vector
+ */
+template <class T>
+void compare(Operator op, int* result, const Operand<T>& left, const Operand<T>& right, size_t size)
+{
+    switch (op) {
+        case Operator::OP_LESS_THAN:
+            map<Less>(result, left, right, size);
+            break;
+        case Operator::OP_LESS_THAN_OR_EQUAL:
+            map<LessOrEqual>(result, left, right, size);
+            break;
+        case Operator::OP_GREATER_THAN:
+            map<Greater>(result, left, right, size);
+            break;
+        case Operator::OP_GREATER_THAN_OR_EQUAL:
+            map<GreaterOrEqual>(result, left, right, size);
+            break;
+        default:
+            break;
+    }
+}
+
+bool is_comparison(Operator op)
+{
+    return op == Operator::OP_LESS_THAN || op == Operator::OP_LESS_THAN_OR_EQUAL
+        || op == Operator::OP_GREATER_THAN || op == Operator::OP_GREATER_THAN_OR_EQUAL;
+}
+
+}
+
+
+VectorObject::VectorObject(Kind kind, size_t size):
+    BaseObject(),
+    kind_(kind)
+{
+    if (kind_ == INTS) {
+        ints_.resize(size);
+    }
+    else {
+        floats_.resize(size);
+    }
+}
+
+VectorObject::VectorObject(VectorObject&& vector):
+    BaseObject(vector),
+    kind_(vector.kind_),
+    ints_(std::move(vector.ints_)),
+    floats_(std::move(vector.floats_))
+{
+}
+
+VectorObject::~VectorObject()
+{
+}
+
+const char* VectorObject::class_name() const
+{
+    return "vector";
+}
+
+VectorObject* VectorObject::from_array(const ArrayObject& array)
+{
+    Kind kind = INTS;
+    for (size_t i = 0; i < array.size(); ++i) {
+        Object::Type type = array.at(i).get_type();
+        if (type == Object::FLOAT) {
+            kind = FLOATS;
+        }
+        else if (type != Object::INT) {
+            throw Error::TypeError("vector elements must be ints or floats");
+        }
+    }
+    VectorObject* vector = new VectorObject(kind, array.size());
+    for (size_t i = 0; i < array.size(); ++i) {
+        if (kind == INTS) {
+            vector->ints_[i] = array.at(i).get_int();
+        }
+        else {
+            vector->floats_[i] = array.at(i).get_float();
+        }
+    }
+    return vector;
+}
+
+VectorObject::Kind VectorObject::kind() const
+{
+    return kind_;
+}
+
+size_t VectorObject::size() const
+{
+    return kind_ == INTS ? ints_.size() : floats_.size();
+}
+
+Object VectorObject::at(size_t index) const
+{
+    return kind_ == INTS ? Object::create_int(ints_[index]) : Object::create_float(floats_[index]);
+}
+
+ArrayObject* VectorObject::to_array() const
+{
+    ArrayObject* array = new ArrayObject(size());
+    for (size_t i = 0; i < size(); ++i) {
+        array->push(at(i));
+    }
+    return array;
+}
+
+std::vector<double> VectorObject::floats() const
+{
+    if (kind_ == FLOATS) {
+        return floats_;
+    }
+    return std::vector<double>(ints_.begin(), ints_.end());
+}
+
+bool VectorObject::eq(const VectorObject& vector) const
+{
+    if (kind_ == INTS && vector.kind_ == INTS) {
+        return ints_ == vector.ints_;
+    }
+    return size() == vector.size() && floats() == vector.floats();
+}
+
+Object VectorObject::apply(Operator op, const Object& left, const Object& right)
+{
+    const VectorObject* left_vector = left.get_type() == Object::VECTOR ? left.get_vector() : nullptr;
+    const VectorObject* right_vector = right.get_type() == Object::VECTOR ? right.get_vector() : nullptr;
+    if ((left_vector == nullptr && left.get_type() != Object::INT && left.get_type() != Object::FLOAT)
+        || (right_vector == nullptr && right.get_type() != Object::INT && right.get_type() != Object::FLOAT)) {
+        throw Error::UnsupportedBinaryOperator(left.get_type(), right.get_type(), op);
+    }
+    if (left_vector != nullptr && right_vector != nullptr && left_vector->size() != right_vector->size()) {
+        throw Error::ValueError("vectors must have the same size");
+    }
+    size_t size = left_vector != nullptr ? left_vector->size() : right_vector->size();
+
+    bool use_floats = (left_vector != nullptr ? left_vector->kind_ == FLOATS : left.get_type() == Object::FLOAT)
+        || (right_vector != nullptr ? right_vector->kind_ == FLOATS : right.get_type() == Object::FLOAT);
+    Kind result_kind = use_floats && !is_comparison(op) ? FLOATS : INTS;
+    VectorObject* result = new VectorObject(result_kind, size);
+    Object result_object = Object::create_vector(result);
+
+    if (!use_floats) {
+        Operand<int> a{left_vector != nullptr ? left_vector->ints_.data() : nullptr, left_vector != nullptr ? 0 : left.get_int()};
+        Operand<int> b{right_vector != nullptr ? right_vector->ints_.data() : nullptr, right_vector != nullptr ? 0 : right.get_int()};
+        int* output = result->ints_.data();
+        switch (op) {
+            case Operator::OP_ADDITION:
+                map<Add>(output, a, b, size);
+                return result_object;
+            case Operator::OP_SUBTRACTION:
+                map<Subtract>(output, a, b, size);
+                return result_object;
+            case Operator::OP_MULTIPLICATION:
+                map<Multiply>(output, a, b, size);
+                return result_object;
+            case Operator::OP_DIVISION:
+                check_divisors(a, b, size);
+                map_scalar(output, a, b, size, [](int x, int y) { return x / y; });
+                return result_object;
+            case Operator::OP_MODULO:
+                check_divisors(a, b, size);
+                map_scalar(output, a, b, size, [](int x, int y) { return x % y; });
+                return result_object;
+            case Operator::OP_POW:
+                map_scalar(output, a, b, size, [](int x, int y) { return static_cast<int>(std::pow(x, y)); });
+                return result_object;
+            default:
+                if (is_comparison(op)) {
+                    compare(op, output, a, b, size);
+                    return result_object;
+                }
+                break;
+        }
+        throw Error::UnsupportedBinaryOperator(left.get_type(), right.get_type(), op);
+    }
+
+    // Int vectors are converted when combined with floats
+    std::vector<double> left_floats, right_floats;
+    if (left_vector != nullptr) {
+        left_floats = left_vector->floats();
+    }
+    if (right_vector != nullptr) {
+        right_floats = right_vector->floats();
+    }
+    Operand<double> a{left_vector != nullptr ? left_floats.data() : nullptr, left_vector != nullptr ? 0 : left.get_float()};
+    Operand<double> b{right_vector != nullptr ? right_floats.data() : nullptr, right_vector != nullptr ? 0 : right.get_float()};
+    if (is_comparison(op)) {
+        compare(op, result->ints_.data(), a, b, size);
+        return result_object;
+    }
+    double* output = result->floats_.data();
+    switch (op) {
+        case Operator::OP_ADDITION:
+            map<Add>(output, a, b, size);
+            return result_object;
+        case Operator::OP_SUBTRACTION:
+            map<Subtract>(output, a, b, size);
+            return result_object;
+        case Operator::OP_MULTIPLICATION:
+            map<Multiply>(output, a, b, size);
+            return result_object;
+        case Operator::OP_DIVISION:
+            if (b.has_zero(size)) {
+                throw Error::DivideByZero();
+            }
+            map<Divide>(output, a, b, size);
+            return result_object;
+        case Operator::OP_MODULO:
+            if (b.has_zero(size)) {
+                throw Error::DivideByZero();
+            }
+            map_scalar(output, a, b, size, [](double x, double y) { return std::fmod(x, y); });
+            return result_object;
+        case Operator::OP_POW:
+            map_scalar(output, a, b, size, [](double x, double y) { return std::pow(x, y); });
+            return result_object;
+        default:
+            break;
+    }
+    throw Error::UnsupportedBinaryOperator(left.get_type(), right.get_type(), op);
+}
+
+void VectorObject::gc_visit(gc::Visitor&)
+{
+    // Numbers never reference shared objects
+}
+
+BaseObject* VectorObject::move_to(void* slot)
+{
+    return ::new (slot) VectorObject(std::move(*this));
+}
+
+size_t VectorObject::external_size() const
+{
+    return ints_.capacity() * sizeof(int) + floats_.capacity() * sizeof(double);
+}
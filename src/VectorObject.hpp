@@ -0,0 +1,90 @@
+#ifndef ASPIC_VECTOR_OBJECT_HPP
+#define ASPIC_VECTOR_OBJECT_HPP
+
+#include "BaseObject.hpp"
+#include "Object.hpp"
+
+#include <vector>
+
+class ArrayObject;
+
+/**
+ * A dense vector of ints or floats
+ *
+ * Arithmetic and comparison operators apply element-wise, between vectors
+ * of same size or between a vector and a scalar (broadcast to each
+ * element), and create new vectors. Comparisons create int vectors of 0
+ * and 1. Vectors hold ints as long as no float is involved.
+ */
+class VectorObject: public BaseObject
+{
+public:
+    enum Kind
+    {
+        INTS,
+        FLOATS
+    };
+
+    /**
+     * Create a vector of zeros
+     */
+    VectorObject(Kind kind, size_t size);
+    ~VectorObject();
+
+    const char* class_name() const override;
+
+    /**
+     * Create a vector from an array of ints and floats
+     * Throw TypeError if array holds other values
+     */
+    static VectorObject* from_array(const ArrayObject& array);
+
+    Kind kind() const;
+
+    size_t size() const;
+
+    /**
+     * Get element at index, as an int or a float object
+     */
+    Object at(size_t index) const;
+
+    /**
+     * Get elements as an array
+     */
+    ArrayObject* to_array() const;
+
+    /**
+     * Compare two vectors (ints and floats are compared as numbers)
+     */
+    bool eq(const VectorObject& vector) const;
+
+    /**
+     * Apply a binary operator element-wise
+     * @param left, right: vectors or numbers (at least one vector), without references
+     * Throw ValueError if vector sizes differ, DivideByZero on a zero divisor
+     */
+    static Object apply(Operator op, const Object& left, const Object& right);
+
+    void gc_visit(gc::Visitor& visitor) override;
+
+    BaseObject* move_to(void* slot) override;
+
+    size_t external_size() const override;
+
+private:
+    VectorObject(const VectorObject&) = delete;
+    VectorObject& operator=(const VectorObject&) = delete;
+
+    VectorObject(VectorObject&& vector);
+
+    /**
+     * Get elements converted to floats
+     */
+    std::vector<double> floats() const;
+
+    Kind kind_;
+    std::vector<int> ints_;
+    std::vector<double> floats_;
+};
+
+#endif
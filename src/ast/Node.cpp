@@ -3,6 +3,11 @@
 #include "SymbolTable.hpp"
 #include "ArrayObject.hpp"
 #include "HashObject.hpp"
+#include "Metrics.hpp"
+#include "gc/Profiler.hpp"
+#include "gc/RefCount.hpp"
+
+#include <climits>
 
 #define SPACES(X) std::string((X) * 4, ' ')
 
@@ -29,10 +34,13 @@ void BodyNode::append(const Node* node)
 
 Object BodyNode::eval() const
 {
+    Metrics::count_node();
     // Return value from the last expression in body (ruby-like)
     size_t loop_length = body_.size() - 1;
     for (size_t i = 0; i < loop_length; ++i) {
         body_[i]->eval();
+        gc::RefCount::safepoint();
+        Metrics::safepoint();
     }
     return body_.back()->eval();
 }
@@ -66,6 +74,7 @@ IfNode::~IfNode()
 
 Object IfNode::eval() const
 {
+    Metrics::count_node();
     if (test_->eval().truthy()) {
         return if_block_->eval();
     }
@@ -109,8 +118,10 @@ LoopNode::~LoopNode()
 
 Object LoopNode::eval() const
 {
+    Metrics::count_node();
     while (test_->eval().truthy()) {
         body_->eval();
+        Metrics::safepoint();
     }
     return Object::create_null();
 }
@@ -138,6 +149,7 @@ UnaryOpNode::~UnaryOpNode()
 
 Object UnaryOpNode::eval() const
 {
+    Metrics::count_node();
     return operand_->eval().apply_unary_operator(op_);
 }
 
@@ -150,10 +162,11 @@ void UnaryOpNode::repr(int depth) const
 
 // BinaryOpNode
 
-BinaryOpNode::BinaryOpNode(Operator op, const Node* first, const Node* second):
+BinaryOpNode::BinaryOpNode(Operator op, const Node* first, const Node* second, uint32_t site):
     op_(op),
     first_(first),
-    second_(second)
+    second_(second),
+    site_(site)
 {
 }
 
@@ -165,6 +178,7 @@ BinaryOpNode::~BinaryOpNode()
 
 Object BinaryOpNode::eval() const
 {
+    Metrics::count_node();
     // ==, !=, ||, &&: operator implementation is not type-dependant
     // eval() is called as late as possible to implement lazy evaluation
     switch (op_) {
@@ -190,6 +204,7 @@ Object BinaryOpNode::eval() const
         }
         default: break;
     }
+    gc::Profiler::Scope scope(site_);
     return first_->eval().apply_binary_operator(op_, second_->eval());
 }
 
@@ -201,10 +216,130 @@ void BinaryOpNode::repr(int depth) const
     std::cout << SPACES(depth) << ")" << std::endl;
 }
 
+// KeyLookupNode
+
+KeyLookupNode::KeyLookupNode(const Node* target, const Object& key):
+    target_(target),
+    key_(key)
+{
+    key_.string_hash();
+}
+
+KeyLookupNode::~KeyLookupNode()
+{
+    delete target_;
+}
+
+Object KeyLookupNode::eval() const
+{
+    Metrics::count_node();
+    Object target = target_->eval();
+    const Object& value = target.get_value();
+    if (value.get_type() == Object::HASHMAP) {
+        return value.get_hashmap()->at(key_, cache_);
+    }
+    return value.apply_binary_operator(Operator::OP_INDEX, key_);
+}
+
+void KeyLookupNode::repr(int depth) const
+{
+    std::cout << SPACES(depth) << "(binary_op " << Operators::to_str(Operator::OP_INDEX) << std::endl;
+    target_->repr(depth + 1);
+    std::cout << SPACES(depth + 1) << key_ << std::endl;
+    std::cout << SPACES(depth) << ")" << std::endl;
+}
+
+// ElementAssignNode
+
+ElementAssignNode::ElementAssignNode(Operator op, const Node* target, const Node* index, const Node* value, uint32_t site):
+    op_(op),
+    target_(target),
+    index_(index),
+    value_(value),
+    site_(site)
+{
+}
+
+ElementAssignNode::~ElementAssignNode()
+{
+    delete target_;
+    delete index_;
+    delete value_;
+}
+
+Object ElementAssignNode::eval() const
+{
+    Metrics::count_node();
+    // Keep a reference on the target, so a temporary container stays alive
+    Object target = target_->eval();
+    Object index = index_->eval();
+    Object value = value_->eval();
+    gc::Profiler::Scope scope(site_);
+    return target.assign_element(op_, index, value);
+}
+
+void ElementAssignNode::repr(int depth) const
+{
+    std::cout << SPACES(depth) << "(element_assign " << Operators::to_str(op_) << std::endl;
+    target_->repr(depth + 1);
+    index_->repr(depth + 1);
+    value_->repr(depth + 1);
+    std::cout << SPACES(depth) << ")" << std::endl;
+}
+
+// SliceNode
+
+SliceNode::SliceNode(const Node* target, const Node* start, const Node* end, uint32_t site):
+    target_(target),
+    start_(start),
+    end_(end),
+    site_(site)
+{
+}
+
+SliceNode::~SliceNode()
+{
+    delete target_;
+    delete start_;
+    delete end_;
+}
+
+Object SliceNode::eval() const
+{
+    Metrics::count_node();
+    Object target = target_->eval();
+    int start = start_ != nullptr ? start_->eval().get_int() : 0;
+    int end = end_ != nullptr ? end_->eval().get_int() : INT_MAX;
+    gc::Profiler::Scope scope(site_);
+    return target.slice(start, end);
+}
+
+void SliceNode::repr(int depth) const
+{
+    std::cout << SPACES(depth) << "(slice" << std::endl;
+    target_->repr(depth + 1);
+    if (start_ != nullptr) {
+        start_->repr(depth + 1);
+    }
+    else {
+        std::cout << SPACES(depth + 1) << "<start>" << std::endl;
+    }
+    if (end_ != nullptr) {
+        end_->repr(depth + 1);
+    }
+    else {
+        std::cout << SPACES(depth + 1) << "<end>" << std::endl;
+    }
+    std::cout << SPACES(depth) << ")" << std::endl;
+}
+
 // FuncCallNode
 
-FuncCallNode::FuncCallNode(const Node* func):
-    func_(func)
+FuncCallNode::FuncCallNode(const Node* func, uint32_t site):
+    func_(func),
+    site_(site),
+    function_(nullptr),
+    calls_(nullptr)
 {
 }
 
@@ -218,8 +353,16 @@ FuncCallNode::~FuncCallNode()
 
 Object FuncCallNode::eval() const
 {
+    Metrics::count_node();
     // Fetch function object, then invoke built-in function with arguments vector
-    return func_->eval().get_function()(arguments_);
+    FunctionWrapper function = func_->eval().get_function();
+    if (function != function_) {
+        function_ = function;
+        calls_ = Metrics::call_counter(function);
+    }
+    ++*calls_;
+    gc::Profiler::Scope scope(site_);
+    return function(arguments_);
 }
 
 void FuncCallNode::repr(int depth) const
@@ -242,10 +385,15 @@ void FuncCallNode::add_arg(const Node* node)
 ValueNode::ValueNode(const Object& object):
     object_(object)
 {
+    // String literals are hashed once, evaluated copies keep the hash
+    if (object_.get_type() == Object::STRING) {
+        object_.string_hash();
+    }
 }
 
 Object ValueNode::eval() const
 {
+    Metrics::count_node();
     return object_;
 }
 
@@ -256,7 +404,8 @@ void ValueNode::repr(int depth) const
 
 // ArrayExprNode
 
-ArrayExprNode::ArrayExprNode()
+ArrayExprNode::ArrayExprNode(uint32_t site):
+    site_(site)
 {
 }
 
@@ -269,6 +418,8 @@ ArrayExprNode::~ArrayExprNode()
 
 Object ArrayExprNode::eval() const
 {
+    Metrics::count_node();
+    gc::Profiler::Scope scope(site_);
     ArrayObject* array = new ArrayObject(values_.size());
     for (auto& node: values_) {
         array->push(node->eval().get_value());
@@ -293,7 +444,8 @@ void ArrayExprNode::add_value(const Node* node)
 
 // HashmapExprNode
 
-HashmapExprNode::HashmapExprNode()
+HashmapExprNode::HashmapExprNode(uint32_t site):
+    site_(site)
 {
 }
 
@@ -307,6 +459,8 @@ HashmapExprNode::~HashmapExprNode()
 
 Object HashmapExprNode::eval() const
 {
+    Metrics::count_node();
+    gc::Profiler::Scope scope(site_);
     HashObject* hash = new HashObject();
     for (auto& kv: values_) {
         hash->push(kv.first->eval().get_value(), kv.second->eval().get_value());
@@ -3,8 +3,11 @@
 
 #include "Operators.hpp"
 #include "Object.hpp"
+#include "HashObject.hpp"
 #include "ast/NodeVector.hpp"
 
+#include <cstdint>
+
 namespace ast {
 
 /**
@@ -104,7 +107,8 @@ private:
 class BinaryOpNode: public Node
 {
 public:
-    BinaryOpNode(Operator op, const Node* first, const Node* second);
+    // site: allocation site ID (see gc::Profiler), 0 if none
+    BinaryOpNode(Operator op, const Node* first, const Node* second, uint32_t site);
 
     ~BinaryOpNode();
 
@@ -117,6 +121,77 @@ private:
     Operator op_;
     const Node* first_;
     const Node* second_;
+    uint32_t site_;
+};
+
+/**
+ * Handle a subscript with a constant string key: target["key"]
+ * Lookups in shaped hashmaps are cached (inline cache).
+ */
+class KeyLookupNode: public Node
+{
+public:
+    KeyLookupNode(const Node* target, const Object& key);
+
+    ~KeyLookupNode();
+
+    // Return value at key
+    Object eval() const override;
+
+    void repr(int depth) const override;
+
+private:
+    const Node* target_;
+    Object key_;
+    mutable HashObject::LookupCache cache_;
+};
+
+/**
+ * Handle an assignment to an element: target[index] = value, or a compound
+ * assignment (target[index] += value, ...)
+ */
+class ElementAssignNode: public Node
+{
+public:
+    // site: allocation site ID (see gc::Profiler), 0 if none
+    ElementAssignNode(Operator op, const Node* target, const Node* index, const Node* value, uint32_t site);
+
+    ~ElementAssignNode();
+
+    // Return new element value
+    Object eval() const override;
+
+    void repr(int depth) const override;
+
+private:
+    Operator op_;
+    const Node* target_;
+    const Node* index_;
+    const Node* value_;
+    uint32_t site_;
+};
+
+/**
+ * Handle a slice expression: target[start:end]
+ */
+class SliceNode: public Node
+{
+public:
+    // start, end: bound expressions, nullptr if omitted
+    SliceNode(const Node* target, const Node* start, const Node* end, uint32_t site);
+
+    ~SliceNode();
+
+    // Return elements in range
+    Object eval() const override;
+
+    void repr(int depth) const override;
+
+private:
+    const Node* target_;
+    const Node* start_;
+    const Node* end_;
+    uint32_t site_;
 };
 
 /**
@@ -143,7 +218,7 @@ private:
 class FuncCallNode: public Node
 {
 public:
-    FuncCallNode(const Node* func);
+    FuncCallNode(const Node* func, uint32_t site);
 
     ~FuncCallNode();
 
@@ -157,6 +232,10 @@ public:
 private:
     const Node* func_;
     NodeVector arguments_;
+    uint32_t site_;
+    // Call counter of the last called function, resolved on first call
+    mutable FunctionWrapper function_;
+    mutable uint64_t* calls_;
 };
 
 /**
@@ -166,7 +245,7 @@ private:
 class ArrayExprNode: public Node
 {
 public:
-    ArrayExprNode();
+    ArrayExprNode(uint32_t site);
     ~ArrayExprNode();
 
     Object eval() const override;
@@ -177,6 +256,7 @@ public:
 
 private:
     NodeVector values_;
+    uint32_t site_;
 };
 
 /**
@@ -186,7 +266,7 @@ private:
 class HashmapExprNode: public Node
 {
 public:
-    HashmapExprNode();
+    HashmapExprNode(uint32_t site);
     ~HashmapExprNode();
 
     Object eval() const override;
@@ -197,6 +277,7 @@ public:
 
 private:
     std::vector<std::pair<const Node*, const Node*>> values_;
+    uint32_t site_;
 };
 
 }
@@ -0,0 +1,445 @@
+#include "LibArray.hpp"
+#include "ast/NodeVector.hpp"
+#include "ast/Node.hpp"
+#include "Error.hpp"
+#include "ArrayObject.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define ASPIC_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Scalar kernels
+// -----------------------------------------------------------------------------
+
+int64_t sum_ints_scalar(const int* data, size_t size)
+{
+    int64_t sum = 0;
+    for (size_t i = 0; i < size; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+double sum_floats_scalar(const double* data, size_t size)
+{
+    double sum = 0;
+    for (size_t i = 0; i < size; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+template <bool Max, class T>
+T extremum_scalar(const T* data, size_t size)
+{
+    T result = data[0];
+    for (size_t i = 1; i < size; ++i) {
+        if (Max ? data[i] > result : data[i] < result) {
+            result = data[i];
+        }
+    }
+    return result;
+}
+
+#ifdef ASPIC_X86_SIMD
+
+// SSE2 kernels (always available on x86-64)
+// -----------------------------------------------------------------------------
+
+int64_t sum_ints_sse2(const int* data, size_t size)
+{
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        // Sign-extend to 64 bits, so the sum cannot overflow
+        __m128i sign = _mm_srai_epi32(values, 31);
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(values, sign));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(values, sign));
+    }
+    int64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return lanes[0] + lanes[1] + sum_ints_scalar(data + i, size - i);
+}
+
+double sum_floats_sse2(const double* data, size_t size)
+{
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(data + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(data + i + 2));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    return lanes[0] + lanes[1] + sum_floats_scalar(data + i, size - i);
+}
+
+template <bool Max>
+int extremum_ints_sse2(const int* data, size_t size)
+{
+    if (size < 4) {
+        return extremum_scalar<Max>(data, size);
+    }
+    // No packed min/max for 32-bit ints before SSE4.1: compare and blend
+    __m128i acc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    size_t i = 4;
+    for (; i + 4 <= size; i += 4) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i keep = Max ? _mm_cmpgt_epi32(acc, values) : _mm_cmplt_epi32(acc, values);
+        acc = _mm_or_si128(_mm_and_si128(keep, acc), _mm_andnot_si128(keep, values));
+    }
+    int lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    int result = extremum_scalar<Max>(lanes, 4);
+    for (; i < size; ++i) {
+        if (Max ? data[i] > result : data[i] < result) {
+            result = data[i];
+        }
+    }
+    return result;
+}
+
+template <bool Max>
+double extremum_floats_sse2(const double* data, size_t size)
+{
+    if (size < 2) {
+        return data[0];
+    }
+    __m128d acc = _mm_loadu_pd(data);
+    size_t i = 2;
+    for (; i + 2 <= size; i += 2) {
+        __m128d values = _mm_loadu_pd(data + i);
+        acc = Max ? _mm_max_pd(acc, values) : _mm_min_pd(acc, values);
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    double result = extremum_scalar<Max>(lanes, 2);
+    for (; i < size; ++i) {
+        if (Max ? data[i] > result : data[i] < result) {
+            result = data[i];
+        }
+    }
+    return result;
+}
+
+// AVX2 kernels (selected at runtime if supported by the CPU)
+// -----------------------------------------------------------------------------
+
+__attribute__((target("avx2")))
+int64_t sum_ints_avx2(const int* data, size_t size)
+{
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(values)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(values, 1)));
+    }
+    int64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(acc0, acc1));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sum_ints_scalar(data + i, size - i);
+}
+
+__attribute__((target("avx2")))
+double sum_floats_avx2(const double* data, size_t size)
+{
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(data + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(data + i + 4));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(acc0, acc1));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + sum_floats_scalar(data + i, size - i);
+}
+
+template <bool Max>
+__attribute__((target("avx2")))
+int extremum_ints_avx2(const int* data, size_t size)
+{
+    if (size < 8) {
+        return extremum_scalar<Max>(data, size);
+    }
+    __m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    size_t i = 8;
+    for (; i + 8 <= size; i += 8) {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        acc = Max ? _mm256_max_epi32(acc, values) : _mm256_min_epi32(acc, values);
+    }
+    int lanes[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    int result = extremum_scalar<Max>(lanes, 8);
+    for (; i < size; ++i) {
+        if (Max ? data[i] > result : data[i] < result) {
+            result = data[i];
+        }
+    }
+    return result;
+}
+
+template <bool Max>
+__attribute__((target("avx2")))
+double extremum_floats_avx2(const double* data, size_t size)
+{
+    if (size < 4) {
+        return extremum_scalar<Max>(data, size);
+    }
+    __m256d acc = _mm256_loadu_pd(data);
+    size_t i = 4;
+    for (; i + 4 <= size; i += 4) {
+        __m256d values = _mm256_loadu_pd(data + i);
+        acc = Max ? _mm256_max_pd(acc, values) : _mm256_min_pd(acc, values);
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    double result = extremum_scalar<Max>(lanes, 4);
+    for (; i < size; ++i) {
+        if (Max ? data[i] > result : data[i] < result) {
+            result = data[i];
+        }
+    }
+    return result;
+}
+
+#endif
+
+// Kernel selection
+// -----------------------------------------------------------------------------
+
+struct Kernels
+{
+    int64_t (*sum_ints)(const int*, size_t);
+    double (*sum_floats)(const double*, size_t);
+    int (*min_ints)(const int*, size_t);
+    int (*max_ints)(const int*, size_t);
+    double (*min_floats)(const double*, size_t);
+    double (*max_floats)(const double*, size_t);
+};
+
+Kernels select_kernels()
+{
+#ifdef ASPIC_X86_SIMD
+    if (__builtin_cpu_supports("avx2")) {
+        return Kernels{
+            sum_ints_avx2, sum_floats_avx2,
+            extremum_ints_avx2<false>, extremum_ints_avx2<true>,
+            extremum_floats_avx2<false>, extremum_floats_avx2<true>
+        };
+    }
+    return Kernels{
+        sum_ints_sse2, sum_floats_sse2,
+        extremum_ints_sse2<false>, extremum_ints_sse2<true>,
+        extremum_floats_sse2<false>, extremum_floats_sse2<true>
+    };
+#else
+    return Kernels{
+        sum_ints_scalar, sum_floats_scalar,
+        extremum_scalar<false, int>, extremum_scalar<true, int>,
+        extremum_scalar<false, double>, extremum_scalar<true, double>
+    };
+#endif
+}
+
+const Kernels& kernels()
+{
+    static const Kernels selected = select_kernels();
+    return selected;
+}
+
+// Helpers
+// -----------------------------------------------------------------------------
+
+/**
+ * Convert elements of a generic array to floats
+ * Raise TypeError if an element is not a number
+ */
+std::vector<double> to_floats(const ArrayObject& array, const char* function)
+{
+    std::vector<double> values;
+    values.reserve(array.size());
+    for (size_t i = 0; i < array.size(); ++i) {
+        Object value = array.at(i);
+        if (value.get_type() != Object::INT && value.get_type() != Object::FLOAT) {
+            throw Error::TypeError(std::string(function) + "() requires an array of numbers");
+        }
+        values.push_back(value.get_float());
+    }
+    return values;
+}
+
+/**
+ * Get sum of ints, as a float if it overflows int
+ */
+Object int_sum(int64_t sum)
+{
+    if (sum < INT_MIN || sum > INT_MAX) {
+        return Object::create_float(sum);
+    }
+    return Object::create_int(sum);
+}
+
+void check_not_empty(const ArrayObject& array, const char* function)
+{
+    if (array.size() == 0) {
+        throw Error::ValueError(std::string(function) + "() arg is an empty array");
+    }
+}
+
+/**
+ * Get index of the first smallest (or largest) element
+ */
+template <bool Max, class T>
+size_t arg_extremum(const T* data, size_t size, T value)
+{
+    size_t index = std::find(data, data + size, value) - data;
+    if (index == size) {
+        // Only happens with NaN values, which don't compare equal
+        index = 0;
+        for (size_t i = 1; i < size; ++i) {
+            if (Max ? data[i] > data[index] : data[i] < data[index]) {
+                index = i;
+            }
+        }
+    }
+    return index;
+}
+
+template <bool Max>
+size_t arg_extremum(const ArrayObject& array, const char* function)
+{
+    check_not_empty(array, function);
+    const Kernels& k = kernels();
+    switch (array.get_kind()) {
+        case ArrayObject::INTS:
+        {
+            const int* data = array.int_data();
+            return arg_extremum<Max>(data, array.size(), (Max ? k.max_ints : k.min_ints)(data, array.size()));
+        }
+        case ArrayObject::FLOATS:
+        {
+            const double* data = array.float_data();
+            return arg_extremum<Max>(data, array.size(), (Max ? k.max_floats : k.min_floats)(data, array.size()));
+        }
+        default:
+        {
+            std::vector<double> values = to_floats(array, function);
+            return arg_extremum<Max>(values.data(), values.size(), (Max ? k.max_floats : k.min_floats)(values.data(), values.size()));
+        }
+    }
+}
+
+template <bool Max>
+Object extremum(const ArrayObject& array, const char* function)
+{
+    check_not_empty(array, function);
+    const Kernels& k = kernels();
+    switch (array.get_kind()) {
+        case ArrayObject::INTS:
+            return Object::create_int((Max ? k.max_ints : k.min_ints)(array.int_data(), array.size()));
+        case ArrayObject::FLOATS:
+            return Object::create_float((Max ? k.max_floats : k.min_floats)(array.float_data(), array.size()));
+        default:
+            // Mixed ints and floats: return the element itself, so its type is kept
+            return array.at(arg_extremum<Max>(array, function));
+    }
+}
+
+}
+
+Object array_sum(const ast::NodeVector& args)
+{
+    args.check(1);
+    // Keep a reference on the array, so a temporary array stays alive
+    Object target = args[0]->eval();
+    const ArrayObject& array = *target.get_array();
+    switch (array.get_kind()) {
+        case ArrayObject::INTS:
+            return int_sum(kernels().sum_ints(array.int_data(), array.size()));
+        case ArrayObject::FLOATS:
+            return Object::create_float(kernels().sum_floats(array.float_data(), array.size()));
+        default:
+        {
+            // Generic storage may still hold only ints (e.g. a slice of a mixed array)
+            int64_t sum = 0;
+            size_t i = 0;
+            for (; i < array.size(); ++i) {
+                Object value = array.at(i);
+                if (value.get_type() != Object::INT) {
+                    break;
+                }
+                sum += value.get_int();
+            }
+            if (i == array.size()) {
+                return int_sum(sum);
+            }
+            std::vector<double> values = to_floats(array, "sum");
+            return Object::create_float(kernels().sum_floats(values.data(), values.size()));
+        }
+    }
+}
+
+Object array_mean(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    const ArrayObject& array = *target.get_array();
+    check_not_empty(array, "mean");
+    double sum;
+    switch (array.get_kind()) {
+        case ArrayObject::INTS:
+            sum = kernels().sum_ints(array.int_data(), array.size());
+            break;
+        case ArrayObject::FLOATS:
+            sum = kernels().sum_floats(array.float_data(), array.size());
+            break;
+        default:
+        {
+            std::vector<double> values = to_floats(array, "mean");
+            sum = kernels().sum_floats(values.data(), values.size());
+            break;
+        }
+    }
+    return Object::create_float(sum / array.size());
+}
+
+Object array_min(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    return extremum<false>(*target.get_array(), "min");
+}
+
+Object array_max(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    return extremum<true>(*target.get_array(), "max");
+}
+
+Object array_argmin(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    return Object::create_int(arg_extremum<false>(*target.get_array(), "argmin"));
+}
+
+Object array_argmax(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    return Object::create_int(arg_extremum<true>(*target.get_array(), "argmax"));
+}
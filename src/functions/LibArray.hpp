@@ -0,0 +1,34 @@
+#ifndef ASPIC_LIBARRAY_HPP
+#define ASPIC_LIBARRAY_HPP
+
+#include "Object.hpp"
+
+namespace ast {
+    class NodeVector;
+}
+
+/**
+ * Array library: aggregates over numeric arrays
+ * Packed int and float arrays are reduced with SIMD kernels (AVX2 or SSE2,
+ * selected at runtime), other arrays must only hold ints and floats.
+ */
+
+// Sum of elements (int if all elements are ints, float otherwise)
+Object array_sum(const ast::NodeVector& args);
+
+// Arithmetic mean of elements, as a float
+Object array_mean(const ast::NodeVector& args);
+
+// Smallest element (see core_min for the 2 arguments form)
+Object array_min(const ast::NodeVector& args);
+
+// Largest element (see core_max for the 2 arguments form)
+Object array_max(const ast::NodeVector& args);
+
+// Index of the first smallest element
+Object array_argmin(const ast::NodeVector& args);
+
+// Index of the first largest element
+Object array_argmax(const ast::NodeVector& args);
+
+#endif
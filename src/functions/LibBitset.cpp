@@ -0,0 +1,99 @@
+#include "LibBitset.hpp"
+#include "ast/NodeVector.hpp"
+#include "ast/Node.hpp"
+#include "Error.hpp"
+#include "ArrayObject.hpp"
+#include "BitsetObject.hpp"
+
+namespace {
+
+Object combine(BitsetObject::Operation operation, const ast::NodeVector& args)
+{
+    args.check(2);
+    Object a = args[0]->eval();
+    Object b = args[1]->eval();
+    return Object::create_bitset(BitsetObject::combine(operation, *a.get_bitset(), *b.get_bitset()));
+}
+
+}
+
+/**
+ * @param 0: size
+ * @param 1: optional array of indexes of set bits
+ * @return new bitset
+ */
+Object bitset_create(const ast::NodeVector& args)
+{
+    args.check(1);
+    int size = args[0]->eval().get_int();
+    if (size < 0) {
+        throw Error::ValueError("bitset size cannot be negative");
+    }
+    BitsetObject* bitset = new BitsetObject(size);
+    Object result = Object::create_bitset(bitset);
+    if (args.size() > 1) {
+        Object source = args[1]->eval();
+        const ArrayObject& indexes = *source.get_array();
+        for (size_t i = 0; i < indexes.size(); ++i) {
+            bitset->set(indexes.at(i).get_int());
+        }
+    }
+    return result;
+}
+
+Object bitset_set(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object target = args[0]->eval();
+    target.get_bitset()->set(args[1]->eval().get_int());
+    return Object::create_null();
+}
+
+Object bitset_clear(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object target = args[0]->eval();
+    target.get_bitset()->clear(args[1]->eval().get_int());
+    return Object::create_null();
+}
+
+Object bitset_test(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object target = args[0]->eval();
+    return Object::create_bool(target.get_bitset()->test(args[1]->eval().get_int()));
+}
+
+Object bitset_count(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    return Object::create_int(target.get_bitset()->count());
+}
+
+Object bitset_indexes(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    return Object::create_array(target.get_bitset()->indexes());
+}
+
+Object bitset_and(const ast::NodeVector& args)
+{
+    return combine(BitsetObject::AND, args);
+}
+
+Object bitset_or(const ast::NodeVector& args)
+{
+    return combine(BitsetObject::OR, args);
+}
+
+Object bitset_xor(const ast::NodeVector& args)
+{
+    return combine(BitsetObject::XOR, args);
+}
+
+Object bitset_andnot(const ast::NodeVector& args)
+{
+    return combine(BitsetObject::ANDNOT, args);
+}
@@ -0,0 +1,34 @@
+#ifndef ASPIC_LIBBITSET_HPP
+#define ASPIC_LIBBITSET_HPP
+
+#include "Object.hpp"
+
+namespace ast {
+    class NodeVector;
+}
+
+/**
+ * Bitset library: fixed-size sets of bits, indexed from 0
+ */
+
+// Create a bitset of given size, with optional array of set bit indexes
+Object bitset_create(const ast::NodeVector& args);
+
+// Set, clear or test a bit
+Object bitset_set(const ast::NodeVector& args);
+Object bitset_clear(const ast::NodeVector& args);
+Object bitset_test(const ast::NodeVector& args);
+
+// Number of set bits
+Object bitset_count(const ast::NodeVector& args);
+
+// Indexes of set bits, as an array
+Object bitset_indexes(const ast::NodeVector& args);
+
+// Bitwise operations between bitsets of same size, results are new bitsets
+Object bitset_and(const ast::NodeVector& args);
+Object bitset_or(const ast::NodeVector& args);
+Object bitset_xor(const ast::NodeVector& args);
+Object bitset_andnot(const ast::NodeVector& args);
+
+#endif
@@ -1,10 +1,15 @@
 #include "LibCore.hpp"
+#include "LibArray.hpp"
 #include "ast/NodeVector.hpp"
 #include "ast/Node.hpp"
 #include "Error.hpp"
 #include "ArrayObject.hpp"
 #include "HashObject.hpp"
+#include "OrderedMapObject.hpp"
+#include "Metrics.hpp"
+#include "gc/Profiler.hpp"
 
+#include <climits>
 #include <iostream>
 #include <random>
 #include <cmath>
@@ -13,16 +18,32 @@
 Object array_push(const ast::NodeVector& args)
 {
     args.check(2);
-    ArrayObject* array = args[0]->eval().get_array();
-    array->push(args[1]->eval());
+    // Keep a reference on the target, so a temporary array stays alive
+    Object target = args[0]->eval();
+    target.get_array()->push(args[1]->eval());
     return Object::create_null();
 }
 
+Object array_freeze(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    target.get_array()->freeze();
+    return target.get_value();
+}
+
+Object array_is_frozen(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    return Object::create_bool(target.get_array()->is_frozen());
+}
+
 Object hash_push(const ast::NodeVector& args)
 {
     args.check(3);
-    HashObject* hash = args[0]->eval().get_hashmap();
-    hash->push(args[1]->eval(), args[2]->eval());
+    Object target = args[0]->eval();
+    target.get_hashmap()->push(args[1]->eval(), args[2]->eval());
     return Object::create_null();
 }
 
@@ -34,6 +55,15 @@ Object core_len(const ast::NodeVector& args)
     );
 }
 
+Object core_slice(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object target = args[0]->eval();
+    int start = args[1]->eval().get_int();
+    int end = args.size() > 2 ? args[2]->eval().get_int() : INT_MAX;
+    return target.slice(start, end);
+}
+
 Object core_rand(const ast::NodeVector& args)
 {
     static std::random_device rd;
@@ -45,6 +75,19 @@ Object core_rand(const ast::NodeVector& args)
     return Object::create_int(distribution(generator));
 }
 
+Object core_runtime_stats(const ast::NodeVector& args)
+{
+    args.check(0);
+    return Metrics::to_hashmap();
+}
+
+Object core_heap_profile(const ast::NodeVector& args)
+{
+    args.check(0);
+    gc::Profiler::report(std::cout);
+    return Object::create_null();
+}
+
 Object array_count(const ast::NodeVector& args)
 {
     args.check(2);
@@ -109,6 +152,9 @@ Object core_round(const ast::NodeVector& args)
 
 Object core_min(const ast::NodeVector& args)
 {
+    if (args.size() == 1) {
+        return array_min(args);
+    }
     args.check(2);
     Object arg1 = args[0]->eval();
     Object arg2 = args[1]->eval();
@@ -117,6 +163,9 @@ Object core_min(const ast::NodeVector& args)
 
 Object core_max(const ast::NodeVector& args)
 {
+    if (args.size() == 1) {
+        return array_max(args);
+    }
     args.check(2);
     Object arg1 = args[0]->eval();
     Object arg2 = args[1]->eval();
@@ -126,6 +175,9 @@ Object core_max(const ast::NodeVector& args)
 Object hash_keys(const ast::NodeVector& args)
 {
     args.check(1);
-    HashObject* hash = args[0]->eval().get_hashmap();
-    return Object::create_array(hash->get_keys());
+    Object target = args[0]->eval();
+    if (target.get_value_type() == Object::ORDMAP) {
+        return Object::create_array(target.get_ordmap()->get_keys());
+    }
+    return Object::create_array(target.get_hashmap()->get_keys());
 }
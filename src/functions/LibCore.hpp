@@ -15,13 +15,26 @@ Object array_push(const ast::NodeVector& args);
 Object array_find(const ast::NodeVector& args);
 Object array_count(const ast::NodeVector& args);
 
+// Make an array immutable and hashable (usable as a hashmap key), return it
+Object array_freeze(const ast::NodeVector& args);
+Object array_is_frozen(const ast::NodeVector& args);
+
 Object hash_push(const ast::NodeVector& args);
 Object hash_keys(const ast::NodeVector& args);
 
 Object core_len(const ast::NodeVector& args);
 
+// slice(target, start[, end]): same as target[start:end]
+Object core_slice(const ast::NodeVector& args);
+
 Object core_rand(const ast::NodeVector& args);
 
+// get interpreter counters (see Metrics) as a hashmap
+Object core_runtime_stats(const ast::NodeVector& args);
+
+// print heap usage per allocation site (see gc::Profiler)
+Object core_heap_profile(const ast::NodeVector& args);
+
 // raise AssertionError if argument != true
 Object core_assert(const ast::NodeVector& args);
 
@@ -37,10 +50,10 @@ Object core_type(const ast::NodeVector& args);
 // round to floating number to x decimals
 Object core_round(const ast::NodeVector& args);
 
-// a < b ? a : b
+// a < b ? a : b, or smallest element of an array (see array_min)
 Object core_min(const ast::NodeVector& args);
 
-// a > b ? a : b
+// a > b ? a : b, or largest element of an array (see array_max)
 Object core_max(const ast::NodeVector& args);
 
 #endif
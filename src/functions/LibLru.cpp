@@ -0,0 +1,84 @@
+#include "LibLru.hpp"
+#include "ast/NodeVector.hpp"
+#include "ast/Node.hpp"
+#include "Error.hpp"
+#include "HashObject.hpp"
+#include "LruObject.hpp"
+
+
+/**
+ * @param 0: capacity
+ * @param 1: optional unit, "entries" (default) or "bytes". With bytes, an
+ *           entry larger than capacity is never stored.
+ * @return new cache
+ */
+Object lru_create(const ast::NodeVector& args)
+{
+    args.check(1);
+    int capacity = args[0]->eval().get_int();
+    if (capacity <= 0) {
+        throw Error::ValueError("lru capacity must be positive");
+    }
+    bool in_bytes = false;
+    if (args.size() > 1) {
+        Object unit = args[1]->eval();
+        if (unit.get_string() == "bytes") {
+            in_bytes = true;
+        }
+        else if (unit.get_string() != "entries") {
+            throw Error::ValueError("lru capacity unit must be \"entries\" or \"bytes\"");
+        }
+    }
+    return Object::create_lru(new LruObject(capacity, in_bytes));
+}
+
+Object lru_get(const ast::NodeVector& args)
+{
+    args.check(2);
+    // Keep a reference on the target, so a temporary cache stays alive
+    Object target = args[0]->eval();
+    const Object* value = target.get_lru()->get(args[1]->eval());
+    if (value != nullptr) {
+        return *value;
+    }
+    return args.size() > 2 ? args[2]->eval() : Object::create_null();
+}
+
+Object lru_put(const ast::NodeVector& args)
+{
+    args.check(3);
+    Object target = args[0]->eval();
+    target.get_lru()->put(args[1]->eval(), args[2]->eval());
+    return Object::create_null();
+}
+
+Object lru_has(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object target = args[0]->eval();
+    return Object::create_bool(target.get_lru()->contains(args[1]->eval()));
+}
+
+Object lru_remove(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object target = args[0]->eval();
+    return Object::create_bool(target.get_lru()->remove(args[1]->eval()));
+}
+
+Object lru_stats(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    const LruObject& lru = *target.get_lru();
+
+    HashObject* stats = new HashObject();
+    Object result = Object::create_hash(stats);
+    stats->push(Object::create_string("hits"), Object::create_counter(lru.hits()));
+    stats->push(Object::create_string("misses"), Object::create_counter(lru.misses()));
+    stats->push(Object::create_string("evictions"), Object::create_counter(lru.evictions()));
+    stats->push(Object::create_string("size"), Object::create_counter(lru.size()));
+    stats->push(Object::create_string("bytes"), Object::create_counter(lru.bytes()));
+    stats->push(Object::create_string("capacity"), Object::create_counter(lru.capacity()));
+    return result;
+}
@@ -0,0 +1,33 @@
+#ifndef ASPIC_LIBLRU_HPP
+#define ASPIC_LIBLRU_HPP
+
+#include "Object.hpp"
+
+namespace ast {
+    class NodeVector;
+}
+
+/**
+ * LRU library: bounded caches evicting the least recently used entries
+ * Only lru_get and lru_put make an entry most recently used.
+ */
+
+// Create a cache holding up to capacity entries, or capacity bytes with "bytes"
+Object lru_create(const ast::NodeVector& args);
+
+// Get the value of a key, or the default value (null if omitted), counting a hit or a miss
+Object lru_get(const ast::NodeVector& args);
+
+// Insert or replace an entry, evicting least recently used entries over capacity
+Object lru_put(const ast::NodeVector& args);
+
+// Check if a key exists
+Object lru_has(const ast::NodeVector& args);
+
+// Remove an entry, return false if key wasn't found
+Object lru_remove(const ast::NodeVector& args);
+
+// Get counters as a hashmap: hits, misses, evictions, size, bytes, capacity
+Object lru_stats(const ast::NodeVector& args);
+
+#endif
@@ -0,0 +1,85 @@
+#include "LibOrdMap.hpp"
+#include "ast/NodeVector.hpp"
+#include "ast/Node.hpp"
+#include "ArrayObject.hpp"
+#include "HashObject.hpp"
+#include "OrderedMapObject.hpp"
+
+
+/**
+ * @param 0: optional hashmap
+ * @return new ordered map
+ */
+Object ordmap_create(const ast::NodeVector& args)
+{
+    OrderedMapObject* map = new OrderedMapObject();
+    Object result = Object::create_ordmap(map);
+    if (args.size() > 0) {
+        Object source = args[0]->eval();
+        const HashObject& hashmap = *source.get_hashmap();
+        for (size_t i = 0; i < hashmap.size(); ++i) {
+            map->set(hashmap.key_at(i), hashmap.value_at(i));
+        }
+    }
+    return result;
+}
+
+Object ordmap_set(const ast::NodeVector& args)
+{
+    args.check(3);
+    // Keep a reference on the target, so a temporary map stays alive
+    Object target = args[0]->eval();
+    target.get_ordmap()->set(args[1]->eval(), args[2]->eval());
+    return Object::create_null();
+}
+
+Object ordmap_has(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object target = args[0]->eval();
+    return Object::create_bool(target.get_ordmap()->find(args[1]->eval()) != nullptr);
+}
+
+Object ordmap_remove(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object target = args[0]->eval();
+    return Object::create_bool(target.get_ordmap()->remove(args[1]->eval()));
+}
+
+Object ordmap_min(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    return target.get_ordmap()->min_key();
+}
+
+Object ordmap_max(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    return target.get_ordmap()->max_key();
+}
+
+Object ordmap_lower_bound(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object target = args[0]->eval();
+    const Object* key = target.get_ordmap()->lower_bound(args[1]->eval());
+    return key != nullptr ? *key : Object::create_null();
+}
+
+Object ordmap_range(const ast::NodeVector& args)
+{
+    args.check(3);
+    Object target = args[0]->eval();
+    Object low = args[1]->eval();
+    Object high = args[2]->eval();
+    return Object::create_array(target.get_ordmap()->range(low, high));
+}
+
+Object ordmap_values(const ast::NodeVector& args)
+{
+    args.check(1);
+    return Object::create_array(args[0]->eval().get_ordmap()->get_values());
+}
@@ -0,0 +1,40 @@
+#ifndef ASPIC_LIBORDMAP_HPP
+#define ASPIC_LIBORDMAP_HPP
+
+#include "Object.hpp"
+
+namespace ast {
+    class NodeVector;
+}
+
+/**
+ * Ordered map library: maps sorted by keys (all numbers or all strings)
+ * Values are read with the [] operator, keys() returns sorted keys.
+ */
+
+// Create an ordered map, empty or from the entries of a hashmap
+Object ordmap_create(const ast::NodeVector& args);
+
+// Add a key, or replace its value
+Object ordmap_set(const ast::NodeVector& args);
+
+// Check if key is present
+Object ordmap_has(const ast::NodeVector& args);
+
+// Remove a key, return false if not present
+Object ordmap_remove(const ast::NodeVector& args);
+
+// Get smallest or largest key
+Object ordmap_min(const ast::NodeVector& args);
+Object ordmap_max(const ast::NodeVector& args);
+
+// Get first key greater than or equal to a key, or null
+Object ordmap_lower_bound(const ast::NodeVector& args);
+
+// Get [key, value] pairs for keys in range [low, high)
+Object ordmap_range(const ast::NodeVector& args);
+
+// Get values, sorted by key
+Object ordmap_values(const ast::NodeVector& args);
+
+#endif
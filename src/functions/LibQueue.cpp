@@ -0,0 +1,127 @@
+#include "LibQueue.hpp"
+#include "ast/NodeVector.hpp"
+#include "ast/Node.hpp"
+#include "Error.hpp"
+#include "ArrayObject.hpp"
+#include "DequeObject.hpp"
+#include "PriorityQueueObject.hpp"
+
+
+/**
+ * @param 0: optional array
+ * @return new deque
+ */
+Object deque_create(const ast::NodeVector& args)
+{
+    DequeObject* deque = new DequeObject();
+    Object result = Object::create_deque(deque);
+    if (args.size() > 0) {
+        Object source = args[0]->eval();
+        const ArrayObject& array = *source.get_array();
+        for (size_t i = 0; i < array.size(); ++i) {
+            deque->push_back(array.at(i));
+        }
+    }
+    return result;
+}
+
+Object deque_push_front(const ast::NodeVector& args)
+{
+    args.check(2);
+    // Keep a reference on the target, so a temporary deque stays alive
+    Object target = args[0]->eval();
+    target.get_deque()->push_front(args[1]->eval());
+    return Object::create_null();
+}
+
+Object deque_push_back(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object target = args[0]->eval();
+    target.get_deque()->push_back(args[1]->eval());
+    return Object::create_null();
+}
+
+Object deque_pop_front(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    return target.get_deque()->pop_front();
+}
+
+Object deque_pop_back(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    return target.get_deque()->pop_back();
+}
+
+Object deque_peek_front(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    DequeObject* deque = target.get_deque();
+    if (deque->size() == 0) {
+        throw Error::ValueError("deque is empty");
+    }
+    return deque->at(0);
+}
+
+Object deque_peek_back(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    DequeObject* deque = target.get_deque();
+    if (deque->size() == 0) {
+        throw Error::ValueError("deque is empty");
+    }
+    return deque->at(deque->size() - 1);
+}
+
+/**
+ * @param 0: optional order, "min" (default) or "max"
+ * @return new priority queue
+ */
+Object pqueue_create(const ast::NodeVector& args)
+{
+    bool max_first = false;
+    if (args.size() > 0) {
+        Object order = args[0]->eval();
+        if (order.get_string() == "max") {
+            max_first = true;
+        }
+        else if (order.get_string() != "min") {
+            throw Error::ValueError("priority queue order must be \"min\" or \"max\"");
+        }
+    }
+    return Object::create_pqueue(new PriorityQueueObject(max_first));
+}
+
+/**
+ * @param 0: priority queue
+ * @param 1: value
+ * @param 2: optional key, compared with the < operator
+ */
+Object pqueue_push(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object target = args[0]->eval();
+    Object value = args[1]->eval();
+    Object key = args.size() > 2 ? args[2]->eval() : value;
+    target.get_pqueue()->push(value, key);
+    return Object::create_null();
+}
+
+Object pqueue_pop(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    return target.get_pqueue()->pop();
+}
+
+Object pqueue_peek(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    return target.get_pqueue()->peek();
+}
@@ -0,0 +1,42 @@
+#ifndef ASPIC_LIBQUEUE_HPP
+#define ASPIC_LIBQUEUE_HPP
+
+#include "Object.hpp"
+
+namespace ast {
+    class NodeVector;
+}
+
+/**
+ * Queue library: double-ended queues and priority queues
+ * Popping or peeking an empty queue raises ValueError.
+ */
+
+// Create a deque, empty or from the elements of an array
+Object deque_create(const ast::NodeVector& args);
+
+// Add a value at one end of a deque
+Object deque_push_front(const ast::NodeVector& args);
+Object deque_push_back(const ast::NodeVector& args);
+
+// Remove and return the value at one end of a deque
+Object deque_pop_front(const ast::NodeVector& args);
+Object deque_pop_back(const ast::NodeVector& args);
+
+// Get the value at one end of a deque
+Object deque_peek_front(const ast::NodeVector& args);
+Object deque_peek_back(const ast::NodeVector& args);
+
+// Create a priority queue, popping smallest keys first, or largest with "max"
+Object pqueue_create(const ast::NodeVector& args);
+
+// Insert a value, with an optional key (the value itself by default)
+Object pqueue_push(const ast::NodeVector& args);
+
+// Remove and return the value with the first key
+Object pqueue_pop(const ast::NodeVector& args);
+
+// Get the value with the first key
+Object pqueue_peek(const ast::NodeVector& args);
+
+#endif
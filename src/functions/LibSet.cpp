@@ -0,0 +1,89 @@
+#include "LibSet.hpp"
+#include "ast/NodeVector.hpp"
+#include "ast/Node.hpp"
+#include "Error.hpp"
+#include "ArrayObject.hpp"
+#include "SetObject.hpp"
+
+
+/**
+ * @param 0: optional array or set
+ * @return new set
+ */
+Object set_create(const ast::NodeVector& args)
+{
+    SetObject* set = new SetObject();
+    Object result = Object::create_set(set);
+    if (args.size() > 0) {
+        Object source = args[0]->eval();
+        const Object& value = source.get_value();
+        if (value.get_type() == Object::ARRAY) {
+            const ArrayObject& array = *value.get_array();
+            for (size_t i = 0; i < array.size(); ++i) {
+                set->add(array.at(i));
+            }
+        }
+        else if (value.get_type() == Object::SET) {
+            const SetObject& other = *value.get_set();
+            for (size_t i = 0; i < other.size(); ++i) {
+                set->add(other.at(i));
+            }
+        }
+        else {
+            throw Error::TypeError("an array or a set is required");
+        }
+    }
+    return result;
+}
+
+Object set_add(const ast::NodeVector& args)
+{
+    args.check(2);
+    // Keep a reference on the target, so a temporary set stays alive
+    Object target = args[0]->eval();
+    return Object::create_bool(target.get_set()->add(args[1]->eval()));
+}
+
+Object set_remove(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object target = args[0]->eval();
+    return Object::create_bool(target.get_set()->remove(args[1]->eval()));
+}
+
+Object set_has(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object target = args[0]->eval();
+    return Object::create_bool(target.get_set()->contains(args[1]->eval()));
+}
+
+Object set_values(const ast::NodeVector& args)
+{
+    args.check(1);
+    return Object::create_array(args[0]->eval().get_set()->to_array());
+}
+
+Object set_union(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object a = args[0]->eval();
+    Object b = args[1]->eval();
+    return Object::create_set(SetObject::set_union(*a.get_set(), *b.get_set()));
+}
+
+Object set_intersection(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object a = args[0]->eval();
+    Object b = args[1]->eval();
+    return Object::create_set(SetObject::set_intersection(*a.get_set(), *b.get_set()));
+}
+
+Object set_difference(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object a = args[0]->eval();
+    Object b = args[1]->eval();
+    return Object::create_set(SetObject::set_difference(*a.get_set(), *b.get_set()));
+}
@@ -0,0 +1,34 @@
+#ifndef ASPIC_LIBSET_HPP
+#define ASPIC_LIBSET_HPP
+
+#include "Object.hpp"
+
+namespace ast {
+    class NodeVector;
+}
+
+/**
+ * Set library: sets of hashable values
+ */
+
+// Create a set, empty or from the elements of an array or a set
+Object set_create(const ast::NodeVector& args);
+
+// Add a value, return false if already present
+Object set_add(const ast::NodeVector& args);
+
+// Remove a value, return false if not present
+Object set_remove(const ast::NodeVector& args);
+
+// Check membership
+Object set_has(const ast::NodeVector& args);
+
+// Get values as an array
+Object set_values(const ast::NodeVector& args);
+
+// Set algebra, results are new sets
+Object set_union(const ast::NodeVector& args);
+Object set_intersection(const ast::NodeVector& args);
+Object set_difference(const ast::NodeVector& args);
+
+#endif
@@ -0,0 +1,145 @@
+#include "LibSketch.hpp"
+#include "ast/NodeVector.hpp"
+#include "ast/Node.hpp"
+#include "Error.hpp"
+#include "BloomFilterObject.hpp"
+#include "HyperLogLogObject.hpp"
+#include "CountMinObject.hpp"
+
+#include <cmath>
+
+namespace {
+
+/**
+ * Get optional argument at index as a probability in (0, 1)
+ */
+double get_rate(const ast::NodeVector& args, size_t index, double default_value, const char* name)
+{
+    if (args.size() <= index) {
+        return default_value;
+    }
+    double rate = args[index]->eval().get_float();
+    if (!(rate > 0 && rate < 1)) {
+        throw Error::ValueError(std::string(name) + " must be between 0 and 1");
+    }
+    return rate;
+}
+
+}
+
+/**
+ * @param 0: expected number of values
+ * @param 1: optional false positive rate
+ * @return new Bloom filter
+ */
+Object bloom_create(const ast::NodeVector& args)
+{
+    args.check(1);
+    int capacity = args[0]->eval().get_int();
+    if (capacity <= 0) {
+        throw Error::ValueError("bloom filter capacity must be positive");
+    }
+    double error_rate = get_rate(args, 1, 0.01, "bloom filter error rate");
+    return Object::create_bloom(new BloomFilterObject(capacity, error_rate));
+}
+
+Object bloom_add(const ast::NodeVector& args)
+{
+    args.check(2);
+    // Keep a reference on the target, so a temporary filter stays alive
+    Object target = args[0]->eval();
+    target.get_bloom()->add(args[1]->eval());
+    return Object::create_null();
+}
+
+Object bloom_has(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object target = args[0]->eval();
+    return Object::create_bool(target.get_bloom()->contains(args[1]->eval()));
+}
+
+Object bloom_merge(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object a = args[0]->eval();
+    Object b = args[1]->eval();
+    return Object::create_bloom(BloomFilterObject::merge(*a.get_bloom(), *b.get_bloom()));
+}
+
+/**
+ * @param 0: optional precision
+ * @return new HyperLogLog sketch
+ */
+Object hll_create(const ast::NodeVector& args)
+{
+    int precision = args.size() > 0 ? args[0]->eval().get_int() : 14;
+    if (precision < HyperLogLogObject::MIN_PRECISION || precision > HyperLogLogObject::MAX_PRECISION) {
+        throw Error::ValueError("hll precision must be between "
+            + std::to_string(HyperLogLogObject::MIN_PRECISION) + " and "
+            + std::to_string(HyperLogLogObject::MAX_PRECISION));
+    }
+    return Object::create_hll(new HyperLogLogObject(precision));
+}
+
+Object hll_add(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object target = args[0]->eval();
+    target.get_hll()->add(args[1]->eval());
+    return Object::create_null();
+}
+
+Object hll_count(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    return Object::create_counter(std::llround(target.get_hll()->count()));
+}
+
+Object hll_merge(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object a = args[0]->eval();
+    Object b = args[1]->eval();
+    return Object::create_hll(HyperLogLogObject::merge(*a.get_hll(), *b.get_hll()));
+}
+
+/**
+ * @param 0: optional epsilon, overestimation relative to the total count
+ * @param 1: optional delta, probability to exceed it
+ * @return new Count-Min sketch
+ */
+Object cms_create(const ast::NodeVector& args)
+{
+    double epsilon = get_rate(args, 0, 0.001, "count-min epsilon");
+    double delta = get_rate(args, 1, 0.01, "count-min delta");
+    return Object::create_cms(new CountMinObject(epsilon, delta));
+}
+
+Object cms_add(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object target = args[0]->eval();
+    int count = args.size() > 2 ? args[2]->eval().get_int() : 1;
+    if (count < 0) {
+        throw Error::ValueError("count-min count cannot be negative");
+    }
+    target.get_cms()->add(args[1]->eval(), count);
+    return Object::create_null();
+}
+
+Object cms_count(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object target = args[0]->eval();
+    return Object::create_counter(target.get_cms()->count(args[1]->eval()));
+}
+
+Object cms_merge(const ast::NodeVector& args)
+{
+    args.check(2);
+    Object a = args[0]->eval();
+    Object b = args[1]->eval();
+    return Object::create_cms(CountMinObject::merge(*a.get_cms(), *b.get_cms()));
+}
@@ -0,0 +1,52 @@
+#ifndef ASPIC_LIBSKETCH_HPP
+#define ASPIC_LIBSKETCH_HPP
+
+#include "Object.hpp"
+
+namespace ast {
+    class NodeVector;
+}
+
+/**
+ * Sketch library: approximate membership, cardinality and frequency of
+ * hashable values, in fixed memory
+ * Sketches of the same size can be merged, to combine per-shard sketches.
+ */
+
+// Create a Bloom filter for capacity values, with a false positive rate (default 0.01)
+Object bloom_create(const ast::NodeVector& args);
+
+// Add a value to a Bloom filter
+Object bloom_add(const ast::NodeVector& args);
+
+// Check if a value may be in a Bloom filter
+Object bloom_has(const ast::NodeVector& args);
+
+// Create a Bloom filter holding values of both filters
+Object bloom_merge(const ast::NodeVector& args);
+
+// Create a HyperLogLog sketch, with 2^precision registers (default 14)
+Object hll_create(const ast::NodeVector& args);
+
+// Add a value to a HyperLogLog sketch
+Object hll_add(const ast::NodeVector& args);
+
+// Estimate the number of distinct values in a HyperLogLog sketch
+Object hll_count(const ast::NodeVector& args);
+
+// Create a HyperLogLog sketch counting values of both sketches
+Object hll_merge(const ast::NodeVector& args);
+
+// Create a Count-Min sketch, with error bounds epsilon (default 0.001) and delta (default 0.01)
+Object cms_create(const ast::NodeVector& args);
+
+// Add occurrences of a value (default 1) to a Count-Min sketch
+Object cms_add(const ast::NodeVector& args);
+
+// Estimate the number of occurrences of a value in a Count-Min sketch
+Object cms_count(const ast::NodeVector& args);
+
+// Create a Count-Min sketch counting values of both sketches
+Object cms_merge(const ast::NodeVector& args);
+
+#endif
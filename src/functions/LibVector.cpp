@@ -0,0 +1,20 @@
+#include "LibVector.hpp"
+#include "ast/NodeVector.hpp"
+#include "ast/Node.hpp"
+#include "ArrayObject.hpp"
+#include "VectorObject.hpp"
+
+
+Object vector_create(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object source = args[0]->eval();
+    return Object::create_vector(VectorObject::from_array(*source.get_array()));
+}
+
+Object vector_values(const ast::NodeVector& args)
+{
+    args.check(1);
+    Object target = args[0]->eval();
+    return Object::create_array(target.get_vector()->to_array());
+}
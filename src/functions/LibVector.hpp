@@ -0,0 +1,21 @@
+#ifndef ASPIC_LIBVECTOR_HPP
+#define ASPIC_LIBVECTOR_HPP
+
+#include "Object.hpp"
+
+namespace ast {
+    class NodeVector;
+}
+
+/**
+ * Vector library: dense numeric vectors
+ * Operators + - * / % ** < <= > >= apply element-wise on vectors.
+ */
+
+// Create a vector from an array of ints and floats
+Object vector_create(const ast::NodeVector& args);
+
+// Get elements as an array
+Object vector_values(const ast::NodeVector& args);
+
+#endif
@@ -0,0 +1,483 @@
+#include "gc/Heap.hpp"
+#include "gc/RefCount.hpp"
+#include "gc/Visitor.hpp"
+#include "BaseObject.hpp"
+#include "Object.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sys/mman.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace gc {
+
+// Init static attributes
+std::vector<Heap::SizeClass> Heap::classes_;
+std::atomic<size_t>          Heap::object_count_(0);
+std::atomic<size_t>          Heap::used_bytes_(0);
+uint64_t                     Heap::allocated_bytes_ = 0;
+bool                         Heap::concurrent_sweep_ = true;
+std::thread                  Heap::sweeper_;
+std::mutex                   Heap::sweeper_mutex_;
+std::condition_variable      Heap::sweeper_cv_;
+std::vector<Heap::Page*>     Heap::sweep_queue_;
+bool                         Heap::sweeper_busy_ = false;
+bool                         Heap::sweeper_stop_ = false;
+
+
+BaseObject* Heap::Page::slot_at(size_t index) const
+{
+    return reinterpret_cast<BaseObject*>(slots + index * slot_size);
+}
+
+size_t Heap::Page::index_of(const void* ptr) const
+{
+    return (static_cast<const char*>(ptr) - slots) / slot_size;
+}
+
+Heap::Page* Heap::page_of(const void* ptr)
+{
+    // Pages are PAGE_SIZE aligned: the header is found by masking the address
+    return reinterpret_cast<Page*>(reinterpret_cast<uintptr_t>(ptr) & ~(PAGE_SIZE - 1));
+}
+
+Heap::Page* Heap::create_page(size_t slot_size)
+{
+    // Pages are mapped directly, so releasing a page returns memory to the system.
+    // Twice the page size is mapped, then the unaligned head and tail are unmapped.
+    void* mapping = mmap(nullptr, 2 * PAGE_SIZE, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    uintptr_t address = reinterpret_cast<uintptr_t>(mapping);
+    size_t head = ((address + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1)) - address;
+    char* memory = static_cast<char*>(mapping) + head;
+    if (head > 0) {
+        munmap(mapping, head);
+    }
+    munmap(memory + PAGE_SIZE, PAGE_SIZE - head);
+
+    Page* page = new (memory) Page();
+    page->state.store(SWEPT);
+    page->evacuated = false;
+    std::memset(page->alloc_bits, 0, sizeof(page->alloc_bits));
+    std::memset(page->mark_bits, 0, sizeof(page->mark_bits));
+
+    size_t header_size = (sizeof(Page) + SLOT_ALIGNMENT - 1) & ~(SLOT_ALIGNMENT - 1);
+    page->slots = memory + header_size;
+    page->slot_size = slot_size;
+    page->slot_count = (PAGE_SIZE - header_size) / slot_size;
+    page->free_count = page->slot_count;
+    return page;
+}
+
+void Heap::destroy_page(Page* page)
+{
+    page->~Page();
+    munmap(page, PAGE_SIZE);
+}
+
+void* Heap::allocate(size_t size)
+{
+    size_t slot_size = size < MIN_SLOT_SIZE
+        ? MIN_SLOT_SIZE
+        : (size + SLOT_ALIGNMENT - 1) & ~(SLOT_ALIGNMENT - 1);
+    if (slot_size > PAGE_SIZE / 8) {
+        throw std::bad_alloc();
+    }
+
+    size_t class_index = slot_size / SLOT_ALIGNMENT;
+    if (class_index >= classes_.size()) {
+        classes_.resize(class_index + 1, SizeClass{{}, 0});
+    }
+    SizeClass& size_class = classes_[class_index];
+
+    // Find a page with a free slot, starting from the cursor
+    while (size_class.cursor < size_class.pages.size()) {
+        Page* page = size_class.pages[size_class.cursor];
+        ensure_swept(page);
+        if (page->free_count > 0) {
+            break;
+        }
+        ++size_class.cursor;
+    }
+    if (size_class.cursor == size_class.pages.size()) {
+        size_class.pages.push_back(create_page(slot_size));
+    }
+    Page* page = size_class.pages[size_class.cursor];
+
+    // Find first zero bit in allocation bitmap
+    for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+        uint64_t free_bits = ~page->alloc_bits[w];
+        if (free_bits != 0) {
+            size_t index = w * 64 + __builtin_ctzll(free_bits);
+            if (index < page->slot_count) {
+                page->alloc_bits[w] |= uint64_t(1) << (index % 64);
+                --page->free_count;
+                ++object_count_;
+                used_bytes_ += slot_size;
+                allocated_bytes_ += slot_size;
+                return page->slot_at(index);
+            }
+        }
+    }
+    // Unreachable: free_count > 0 guarantees a free slot
+    throw std::bad_alloc();
+}
+
+void Heap::deallocate(void* ptr)
+{
+    Page* page = page_of(ptr);
+    size_t index = page->index_of(ptr);
+    page->alloc_bits[index / 64] &= ~(uint64_t(1) << (index % 64));
+    page->mark_bits[index / 64] &= ~(uint64_t(1) << (index % 64));
+    ++page->free_count;
+    --object_count_;
+    used_bytes_ -= page->slot_size;
+    classes_[page->slot_size / SLOT_ALIGNMENT].cursor = 0;
+}
+
+bool Heap::mark(const BaseObject* object)
+{
+    Page* page = page_of(object);
+    size_t index = page->index_of(object);
+    uint64_t bit = uint64_t(1) << (index % 64);
+    uint64_t& word = page->mark_bits[index / 64];
+    if (word & bit) {
+        return false;
+    }
+    word |= bit;
+    return true;
+}
+
+bool Heap::mark_atomic(const BaseObject* object)
+{
+    Page* page = page_of(object);
+    size_t index = page->index_of(object);
+    uint64_t bit = uint64_t(1) << (index % 64);
+    uint64_t* word = &page->mark_bits[index / 64];
+    // Cheap check first, to avoid a locked operation on already marked objects
+    if (__atomic_load_n(word, __ATOMIC_RELAXED) & bit) {
+        return false;
+    }
+    return (__atomic_fetch_or(word, bit, __ATOMIC_RELAXED) & bit) == 0;
+}
+
+bool Heap::is_marked(const BaseObject* object)
+{
+    Page* page = page_of(object);
+    size_t index = page->index_of(object);
+    return page->mark_bits[index / 64] & (uint64_t(1) << (index % 64));
+}
+
+void Heap::sweep_page(Page* page)
+{
+    size_t destroyed = 0;
+    for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+        uint64_t dead = page->alloc_bits[w] & ~page->mark_bits[w];
+        while (dead != 0) {
+            size_t index = w * 64 + __builtin_ctzll(dead);
+            dead &= dead - 1;
+            page->slot_at(index)->~BaseObject();
+            ++destroyed;
+        }
+        // Surviving objects are the marked ones, marks are reset for next cycle
+        page->alloc_bits[w] &= page->mark_bits[w];
+        page->mark_bits[w] = 0;
+    }
+    page->free_count += destroyed;
+    object_count_ -= destroyed;
+    used_bytes_ -= destroyed * page->slot_size;
+    page->state.store(SWEPT, std::memory_order_release);
+}
+
+void Heap::ensure_swept(Page* page)
+{
+    int state = page->state.load(std::memory_order_acquire);
+    if (state == SWEPT) {
+        return;
+    }
+    int expected = NEEDS_SWEEP;
+    if (state == NEEDS_SWEEP && page->state.compare_exchange_strong(expected, SWEEPING,
+        std::memory_order_acquire)) {
+        // Lazy sweeping: the allocator needs this page before the sweeper reached it
+        sweep_page(page);
+        return;
+    }
+    // Page is currently swept by the background thread
+    while (page->state.load(std::memory_order_acquire) != SWEPT) {
+        std::this_thread::yield();
+    }
+}
+
+void Heap::sweep()
+{
+    finish_sweep();
+    std::vector<Page*> queue;
+    for (SizeClass& size_class: classes_) {
+        for (Page* page: size_class.pages) {
+            page->state.store(NEEDS_SWEEP, std::memory_order_release);
+            queue.push_back(page);
+        }
+        size_class.cursor = 0;
+    }
+
+    if (!concurrent_sweep_) {
+        for (Page* page: queue) {
+            ensure_swept(page);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(sweeper_mutex_);
+    if (!sweeper_.joinable()) {
+        sweeper_stop_ = false;
+        sweeper_ = std::thread(run_sweeper);
+    }
+    sweep_queue_.swap(queue);
+    sweeper_busy_ = true;
+    sweeper_cv_.notify_all();
+}
+
+void Heap::run_sweeper()
+{
+    std::unique_lock<std::mutex> lock(sweeper_mutex_);
+    while (true) {
+        sweeper_cv_.wait(lock, [] { return sweeper_busy_ || sweeper_stop_; });
+        if (!sweeper_busy_) {
+            return;
+        }
+        lock.unlock();
+        for (Page* page: sweep_queue_) {
+            int expected = NEEDS_SWEEP;
+            if (page->state.compare_exchange_strong(expected, SWEEPING, std::memory_order_acquire)) {
+                sweep_page(page);
+            }
+        }
+        lock.lock();
+        sweeper_busy_ = false;
+        sweeper_cv_.notify_all();
+    }
+}
+
+void Heap::finish_sweep()
+{
+    {
+        std::unique_lock<std::mutex> lock(sweeper_mutex_);
+        sweeper_cv_.wait(lock, [] { return !sweeper_busy_; });
+        sweep_queue_.clear();
+    }
+    // Pages left unswept by the sweeper are being swept on demand by the allocator,
+    // which runs on this thread: all pages are swept at this point
+    for (SizeClass& size_class: classes_) {
+        size_t kept = 0;
+        for (Page* page: size_class.pages) {
+            if (page->free_count == page->slot_count) {
+                destroy_page(page);
+            }
+            else {
+                size_class.pages[kept++] = page;
+            }
+        }
+        size_class.pages.resize(kept);
+        size_class.cursor = 0;
+    }
+}
+
+void Heap::shutdown()
+{
+    finish_sweep();
+    {
+        std::lock_guard<std::mutex> lock(sweeper_mutex_);
+        sweeper_stop_ = true;
+        sweeper_cv_.notify_all();
+    }
+    if (sweeper_.joinable()) {
+        sweeper_.join();
+    }
+}
+
+void Heap::set_concurrent_sweep(bool enabled)
+{
+    finish_sweep();
+    concurrent_sweep_ = enabled;
+}
+
+size_t Heap::object_count()
+{
+    return object_count_;
+}
+
+size_t Heap::page_count()
+{
+    size_t count = 0;
+    for (const SizeClass& size_class: classes_) {
+        count += size_class.pages.size();
+    }
+    return count;
+}
+
+size_t Heap::slot_size(const BaseObject* object)
+{
+    return page_of(object)->slot_size;
+}
+
+uint64_t Heap::allocated_bytes()
+{
+    return allocated_bytes_;
+}
+
+// Compaction
+// -----------------------------------------------------------------------------
+
+/**
+ * Update references to moved objects
+ */
+class Forwarder: public Visitor
+{
+public:
+    void visit(Object& object) override
+    {
+        BaseObject* current = object.get_shared_object();
+        BaseObject* moved = Heap::forward(current);
+        if (moved != current) {
+            object.relocate(moved);
+        }
+    }
+};
+
+BaseObject* Heap::forward(BaseObject* object)
+{
+    // An evacuated slot holds the new address of its former object
+    if (page_of(object)->evacuated) {
+        return *reinterpret_cast<BaseObject**>(object);
+    }
+    return object;
+}
+
+void Heap::evacuate(Page* source, std::vector<Page*>& targets, size_t& target_index)
+{
+    for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+        uint64_t bits = source->alloc_bits[w];
+        while (bits != 0) {
+            size_t index = w * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+
+            // Find next free slot in target pages
+            while (targets[target_index]->free_count == 0) {
+                ++target_index;
+            }
+            Page* target = targets[target_index];
+            size_t slot = 0;
+            for (size_t tw = 0; tw < BITMAP_WORDS; ++tw) {
+                uint64_t free_bits = ~target->alloc_bits[tw];
+                if (free_bits != 0) {
+                    slot = tw * 64 + __builtin_ctzll(free_bits);
+                    break;
+                }
+            }
+            target->alloc_bits[slot / 64] |= uint64_t(1) << (slot % 64);
+            --target->free_count;
+
+            BaseObject* object = source->slot_at(index);
+            BaseObject* moved = object->move_to(target->slot_at(slot));
+            if (RefCount::enabled()) {
+                RefCount::relocate(object, moved);
+            }
+            object->~BaseObject();
+            *reinterpret_cast<BaseObject**>(object) = moved;
+        }
+        source->alloc_bits[w] = 0;
+    }
+    source->free_count = source->slot_count;
+    source->evacuated = true;
+}
+
+size_t Heap::compact(const std::vector<Object*>& roots)
+{
+    finish_sweep();
+
+    std::vector<Page*> evacuated;
+    for (SizeClass& size_class: classes_) {
+        if (size_class.pages.size() < 2) {
+            continue;
+        }
+        // Keep the densest pages, just enough to hold all live objects
+        std::vector<Page*>& pages = size_class.pages;
+        std::sort(pages.begin(), pages.end(), [](const Page* a, const Page* b) {
+            return a->free_count < b->free_count;
+        });
+        size_t live = 0;
+        for (const Page* page: pages) {
+            live += page->slot_count - page->free_count;
+        }
+        size_t slot_count = pages.front()->slot_count;
+        size_t needed = (live + slot_count - 1) / slot_count;
+        if (needed >= pages.size()) {
+            continue;
+        }
+
+        std::vector<Page*> targets(pages.begin(), pages.begin() + needed);
+        size_t target_index = 0;
+        for (size_t i = needed; i < pages.size(); ++i) {
+            evacuate(pages[i], targets, target_index);
+            evacuated.push_back(pages[i]);
+        }
+        pages.swap(targets);
+        size_class.cursor = 0;
+    }
+    if (evacuated.empty()) {
+        return 0;
+    }
+
+    // Update references held by roots and by all remaining objects
+    Forwarder forwarder;
+    for (Object* root: roots) {
+        root->gc_visit(forwarder);
+    }
+    for_each_object([&forwarder](BaseObject* object) {
+        object->gc_visit(forwarder);
+    });
+
+    for (Page* page: evacuated) {
+        destroy_page(page);
+    }
+#ifdef __GLIBC__
+    // Also give back memory freed by containers storage
+    malloc_trim(0);
+#endif
+    return evacuated.size();
+}
+
+double Heap::Stats::fragmentation() const
+{
+    return page_bytes > 0 ? 1.0 - static_cast<double>(used_bytes) / page_bytes : 0.0;
+}
+
+Heap::Stats Heap::get_stats()
+{
+    Stats stats = {0, 0, 0, 0};
+    for (const SizeClass& size_class: classes_) {
+        for (const Page* page: size_class.pages) {
+            stats.object_count += page->slot_count - page->free_count;
+            stats.used_bytes += (page->slot_count - page->free_count) * page->slot_size;
+            stats.page_bytes += PAGE_SIZE;
+            ++stats.page_count;
+        }
+    }
+    return stats;
+}
+
+Heap::Stats Heap::current_stats()
+{
+    // Pages are only created and released by the interpreter thread
+    size_t pages = page_count();
+    return Stats{object_count_, pages, used_bytes_, pages * PAGE_SIZE};
+}
+
+}
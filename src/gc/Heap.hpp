@@ -0,0 +1,256 @@
+#ifndef ASPIC_GC_HEAP_HPP
+#define ASPIC_GC_HEAP_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class BaseObject;
+class Object;
+
+namespace gc {
+
+/**
+ * Segregated heap for BaseObject instances.
+ *
+ * Objects are allocated in fixed-size slots, grouped by size class into
+ * aligned pages. Each page keeps two side bitmaps: one for allocated slots,
+ * one for slots marked as reachable by the garbage collector. Sweeping is a
+ * linear scan over these bitmaps, no per-object list is needed.
+ *
+ * Sweeping runs on a background thread: once marking is done, pages are
+ * flagged as unswept and handed to the sweeper, while the interpreter
+ * resumes. An unswept page needed by the allocator is swept on demand.
+ *
+ * Long running interpreters may end up with many sparse pages. Compaction
+ * relocates live objects into the densest pages, so the other ones can be
+ * released.
+ */
+class Heap
+{
+public:
+    /**
+     * Allocate a slot large enough for size bytes (see BaseObject::operator new)
+     */
+    static void* allocate(size_t size);
+
+    /**
+     * Release a slot without running the destructor (see BaseObject::operator delete)
+     */
+    static void deallocate(void* ptr);
+
+    /**
+     * Set the mark bit of an object
+     * @return true if object was not marked yet
+     */
+    static bool mark(const BaseObject* object);
+
+    /**
+     * Same as mark, safe to call concurrently from several marking threads
+     */
+    static bool mark_atomic(const BaseObject* object);
+
+    /**
+     * Get the mark bit of an object
+     */
+    static bool is_marked(const BaseObject* object);
+
+    /**
+     * Start destroying all allocated objects which haven't been marked, and
+     * reset the mark bits. Pages are swept in the background, or inline if
+     * concurrent sweeping is disabled.
+     */
+    static void sweep();
+
+    /**
+     * Wait until all pages have been swept, and return empty pages to the
+     * system. Must be called before marking again.
+     */
+    static void finish_sweep();
+
+    /**
+     * Finish sweeping and stop the background sweeper
+     */
+    static void shutdown();
+
+    /**
+     * Enable or disable sweeping on a background thread (default: enabled)
+     */
+    static void set_concurrent_sweep(bool enabled);
+
+    /**
+     * Move live objects out of sparse pages, then release these pages.
+     * References to moved objects are updated in the given roots and in all
+     * heap objects. No raw pointer to a heap object must be held elsewhere.
+     * @return number of released pages
+     */
+    static size_t compact(const std::vector<Object*>& roots);
+
+    /**
+     * Get size of the slot holding an object
+     */
+    static size_t slot_size(const BaseObject* object);
+
+    /**
+     * Heap usage summary
+     */
+    struct Stats
+    {
+        size_t object_count;
+        size_t page_count;
+        size_t used_bytes; // size of allocated slots
+        size_t page_bytes; // size of all pages
+
+        /**
+         * Ratio of page memory not used by allocated slots (between 0 and 1)
+         */
+        double fragmentation() const;
+    };
+
+    static Stats get_stats();
+
+    /**
+     * Heap usage from the counters kept by the allocator and the sweeper.
+     * Doesn't wait for the background sweeper, so dead objects which haven't
+     * been swept yet are still counted.
+     */
+    static Stats current_stats();
+
+    /**
+     * Invoke callback on each allocated object
+     * finish_sweep must have been called first, so dead objects are not listed.
+     */
+    template <class Callback>
+    static void for_each_object(Callback callback);
+
+    /**
+     * Number of allocated objects (including dead objects not swept yet)
+     */
+    static size_t object_count();
+
+    /**
+     * Number of pages currently held by the heap
+     */
+    static size_t page_count();
+
+    /**
+     * Total size of slots allocated since startup
+     */
+    static uint64_t allocated_bytes();
+
+    static const size_t PAGE_SIZE = 64 * 1024;
+    static const size_t SLOT_ALIGNMENT = 16;
+
+private:
+    Heap() = delete;
+
+    static const size_t MIN_SLOT_SIZE = SLOT_ALIGNMENT;
+    static const size_t MAX_SLOTS = PAGE_SIZE / MIN_SLOT_SIZE;
+    static const size_t BITMAP_WORDS = MAX_SLOTS / 64;
+
+    enum PageState
+    {
+        SWEPT,       // bitmaps are up-to-date, page can be used by the allocator
+        NEEDS_SWEEP, // page holds dead objects from last marking
+        SWEEPING,    // page is being swept by a thread
+    };
+
+    /**
+     * Page header, stored at the beginning of each PAGE_SIZE aligned block.
+     * Slots follow the header.
+     */
+    struct Page
+    {
+        size_t slot_size;
+        size_t slot_count;
+        size_t free_count;
+        char* slots;
+        std::atomic<int> state;
+        bool evacuated; // objects have been moved out by compaction
+        uint64_t alloc_bits[BITMAP_WORDS];
+        uint64_t mark_bits[BITMAP_WORDS];
+
+        BaseObject* slot_at(size_t index) const;
+        size_t index_of(const void* ptr) const;
+    };
+
+    /**
+     * Pages holding slots of the same size
+     */
+    struct SizeClass
+    {
+        std::vector<Page*> pages;
+        size_t cursor; // index of the first page which may have free slots
+    };
+
+    static Page* page_of(const void* ptr);
+
+    /**
+     * Get current address of an object, which may have been moved by compaction
+     */
+    static BaseObject* forward(BaseObject* object);
+
+    /**
+     * Move all objects of the source page to free slots in the target pages
+     */
+    static void evacuate(Page* source, std::vector<Page*>& targets, size_t& target_index);
+
+    static Page* create_page(size_t slot_size);
+    static void destroy_page(Page* page);
+
+    /**
+     * Sweep page if it hasn't been swept yet, or wait for the thread sweeping it
+     */
+    static void ensure_swept(Page* page);
+
+    /**
+     * Destroy dead objects in page and reset its mark bits
+     */
+    static void sweep_page(Page* page);
+
+    /**
+     * Background sweeper thread loop
+     */
+    static void run_sweeper();
+
+    static std::vector<SizeClass> classes_;
+    static std::atomic<size_t> object_count_;
+    static std::atomic<size_t> used_bytes_; // size of allocated slots
+    static uint64_t allocated_bytes_;
+
+    // Background sweeper
+    static bool concurrent_sweep_;
+    static std::thread sweeper_;
+    static std::mutex sweeper_mutex_;
+    static std::condition_variable sweeper_cv_;
+    static std::vector<Page*> sweep_queue_;
+    static bool sweeper_busy_;
+    static bool sweeper_stop_;
+
+    friend class Forwarder;
+};
+
+template <class Callback>
+void Heap::for_each_object(Callback callback)
+{
+    for (const SizeClass& size_class: classes_) {
+        for (const Page* page: size_class.pages) {
+            for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+                uint64_t bits = page->alloc_bits[w];
+                while (bits != 0) {
+                    size_t index = w * 64 + __builtin_ctzll(bits);
+                    bits &= bits - 1;
+                    callback(page->slot_at(index));
+                }
+            }
+        }
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,170 @@
+#include "gc/Marker.hpp"
+#include "gc/Heap.hpp"
+#include "BaseObject.hpp"
+#include "Object.hpp"
+
+#include <thread>
+
+namespace gc {
+
+size_t Marker::thread_count_ = 1;
+
+/**
+ * Work published by a worker: the owner pushes at the back, thieves take
+ * from the front, so the oldest (and usually largest) subgraphs are stolen
+ */
+struct Marker::SharedDeque
+{
+    std::mutex mutex;
+    std::deque<BaseObject*> items;
+    std::atomic<size_t> size{0};
+};
+
+
+Marker::Marker(std::vector<SharedDeque*>* deques, size_t id):
+    deques_(deques),
+    id_(id)
+{
+}
+
+void Marker::set_thread_count(size_t count)
+{
+    thread_count_ = count > 0 ? count : 1;
+}
+
+size_t Marker::get_thread_count()
+{
+    return thread_count_;
+}
+
+void Marker::visit(Object& object)
+{
+    BaseObject* shared = object.get_shared_object();
+    if (deques_ == nullptr ? Heap::mark(shared) : Heap::mark_atomic(shared)) {
+        stack_.push_back(shared);
+        if (deques_ != nullptr && stack_.size() > PUBLISH_THRESHOLD
+            && (*deques_)[id_]->size.load(std::memory_order_relaxed) == 0) {
+            publish();
+        }
+    }
+}
+
+void Marker::drain()
+{
+    while (!stack_.empty()) {
+        BaseObject* object = stack_.back();
+        stack_.pop_back();
+        object->gc_visit(*this);
+    }
+}
+
+void Marker::mark_from_roots(const std::vector<Object*>& roots)
+{
+    size_t threads = thread_count_;
+    if (threads <= 1 || Heap::object_count() < PARALLEL_THRESHOLD) {
+        Marker marker(nullptr, 0);
+        for (Object* root: roots) {
+            root->gc_visit(marker);
+            marker.drain();
+        }
+        return;
+    }
+
+    std::vector<SharedDeque*> deques;
+    std::vector<Marker> markers;
+    for (size_t i = 0; i < threads; ++i) {
+        deques.push_back(new SharedDeque());
+        markers.push_back(Marker(&deques, i));
+    }
+
+    // Each worker scans a slice of the roots, then traces and steals
+    std::atomic<size_t> idle(0);
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(&Marker::run, &markers[i], std::cref(roots),
+            roots.size() * i / threads, roots.size() * (i + 1) / threads, std::ref(idle));
+    }
+    markers[0].run(roots, 0, roots.size() / threads, idle);
+    for (std::thread& worker: workers) {
+        worker.join();
+    }
+    for (SharedDeque* deque: deques) {
+        delete deque;
+    }
+}
+
+void Marker::run(const std::vector<Object*>& roots, size_t begin, size_t end, std::atomic<size_t>& idle)
+{
+    for (size_t i = begin; i < end; ++i) {
+        roots[i]->gc_visit(*this);
+        drain();
+    }
+
+    const size_t threads = deques_->size();
+    while (true) {
+        drain();
+        if (acquire()) {
+            continue;
+        }
+        // No work left for this worker: wait until either another worker
+        // publishes something, or all workers are idle
+        idle.fetch_add(1);
+        while (true) {
+            if (idle.load() == threads) {
+                return;
+            }
+            bool pending = false;
+            for (SharedDeque* deque: *deques_) {
+                if (deque->size.load(std::memory_order_relaxed) > 0) {
+                    pending = true;
+                    break;
+                }
+            }
+            if (pending) {
+                idle.fetch_sub(1);
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+}
+
+void Marker::publish()
+{
+    SharedDeque& deque = *(*deques_)[id_];
+    size_t half = stack_.size() / 2;
+    std::lock_guard<std::mutex> lock(deque.mutex);
+    deque.items.insert(deque.items.end(), stack_.begin(), stack_.begin() + half);
+    deque.size.store(deque.items.size());
+    stack_.erase(stack_.begin(), stack_.begin() + half);
+}
+
+bool Marker::acquire()
+{
+    const size_t threads = deques_->size();
+    for (size_t i = 0; i < threads; ++i) {
+        SharedDeque& deque = *(*deques_)[(id_ + i) % threads];
+        if (deque.size.load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(deque.mutex);
+        if (deque.items.empty()) {
+            continue;
+        }
+        // Owner takes everything from the back, thieves take half from the front
+        size_t count = i == 0 ? deque.items.size() : (deque.items.size() + 1) / 2;
+        if (i == 0) {
+            stack_.insert(stack_.end(), deque.items.end() - count, deque.items.end());
+            deque.items.erase(deque.items.end() - count, deque.items.end());
+        }
+        else {
+            stack_.insert(stack_.end(), deque.items.begin(), deque.items.begin() + count);
+            deque.items.erase(deque.items.begin(), deque.items.begin() + count);
+        }
+        deque.size.store(deque.items.size());
+        return true;
+    }
+    return false;
+}
+
+}
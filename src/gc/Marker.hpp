@@ -0,0 +1,87 @@
+#ifndef ASPIC_GC_MARKER_HPP
+#define ASPIC_GC_MARKER_HPP
+
+#include "gc/Visitor.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+class BaseObject;
+
+namespace gc {
+
+/**
+ * Mark phase of the garbage collector.
+ *
+ * Reachable objects are traced with an explicit mark stack instead of
+ * recursion, so deeply nested containers cannot overflow the C++ stack.
+ * On large heaps, tracing can be spread across several worker threads: each
+ * worker owns a private stack and publishes surplus work in a shared deque,
+ * which idle workers steal from.
+ */
+class Marker: public Visitor
+{
+public:
+    /**
+     * Mark all objects reachable from the given roots
+     */
+    static void mark_from_roots(const std::vector<Object*>& roots);
+
+    /**
+     * Set number of threads used for marking large heaps (1: no parallel marking)
+     */
+    static void set_thread_count(size_t count);
+
+    static size_t get_thread_count();
+
+    /**
+     * Minimum number of heap objects before marking in parallel
+     */
+    static const size_t PARALLEL_THRESHOLD = 100000;
+
+    /**
+     * Push newly marked shared object on the mark stack
+     */
+    void visit(Object& object) override;
+
+private:
+    struct SharedDeque;
+
+    Marker(std::vector<SharedDeque*>* deques, size_t id);
+
+    /**
+     * Trace objects until the mark stack is empty
+     */
+    void drain();
+
+    /**
+     * Worker loop for parallel marking
+     */
+    void run(const std::vector<Object*>& roots, size_t begin, size_t end, std::atomic<size_t>& idle);
+
+    /**
+     * Move the bottom half of the private stack to the shared deque
+     */
+    void publish();
+
+    /**
+     * Take work from the own shared deque, or steal from another worker
+     */
+    bool acquire();
+
+    // Private stack size which triggers publishing work for other workers
+    static const size_t PUBLISH_THRESHOLD = 64;
+
+    static size_t thread_count_;
+
+    std::vector<BaseObject*> stack_;
+    std::vector<SharedDeque*>* deques_; // nullptr when marking serially
+    size_t id_;
+};
+
+}
+
+#endif
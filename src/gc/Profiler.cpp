@@ -0,0 +1,101 @@
+#include "gc/Profiler.hpp"
+#include "gc/Heap.hpp"
+#include "BaseObject.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace gc {
+
+// Init static attributes
+bool                   Profiler::enabled_ = false;
+uint32_t               Profiler::current_site_ = 0;
+std::vector<Profiler::Site> Profiler::sites_;
+std::map<std::pair<std::string, int>, uint32_t> Profiler::site_ids_;
+
+
+void Profiler::enable()
+{
+    enabled_ = true;
+    if (sites_.empty()) {
+        sites_.push_back(Site{"<unknown>", 0, 0, 0});
+    }
+}
+
+uint32_t Profiler::register_site(const std::string& label, int line)
+{
+    if (!enabled_) {
+        return 0;
+    }
+    auto it = site_ids_.find(std::make_pair(label, line));
+    if (it != site_ids_.end()) {
+        return it->second;
+    }
+    uint32_t id = sites_.size();
+    sites_.push_back(Site{label, line, 0, 0});
+    site_ids_.emplace(std::make_pair(label, line), id);
+    return id;
+}
+
+void Profiler::record_object(BaseObject* object)
+{
+    if (!enabled_) {
+        return;
+    }
+    object->alloc_site_ = current_site_;
+    Site& site = sites_[current_site_];
+    ++site.total_count;
+    site.total_bytes += Heap::slot_size(object) + object->external_size();
+}
+
+void Profiler::record_large_string(size_t size)
+{
+    Site& site = sites_[current_site_];
+    ++site.total_count;
+    site.total_bytes += size;
+}
+
+void Profiler::report(std::ostream& os)
+{
+    if (!enabled_) {
+        os << "Heap profiler is disabled (see --heap-profile)" << std::endl;
+        return;
+    }
+
+    // Live usage is computed from objects currently in the heap
+    std::vector<size_t> live_count(sites_.size(), 0);
+    std::vector<size_t> live_bytes(sites_.size(), 0);
+    Heap::finish_sweep();
+    Heap::for_each_object([&](const BaseObject* object) {
+        uint32_t site = object->alloc_site_ < sites_.size() ? object->alloc_site_ : 0;
+        ++live_count[site];
+        live_bytes[site] += Heap::slot_size(object) + object->external_size();
+    });
+
+    std::vector<uint32_t> order;
+    for (uint32_t i = 0; i < sites_.size(); ++i) {
+        if (sites_[i].total_count > 0 || live_count[i] > 0) {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return live_bytes[a] != live_bytes[b]
+            ? live_bytes[a] > live_bytes[b]
+            : sites_[a].total_bytes > sites_[b].total_bytes;
+    });
+
+    os << std::left << std::setw(24) << "site" << std::right
+        << std::setw(6) << "line"
+        << std::setw(12) << "live objs" << std::setw(14) << "live bytes"
+        << std::setw(12) << "total objs" << std::setw(14) << "total bytes" << std::endl;
+    for (uint32_t i: order) {
+        const Site& site = sites_[i];
+        os << std::left << std::setw(24) << site.label << std::right
+            << std::setw(6) << site.line
+            << std::setw(12) << live_count[i] << std::setw(14) << live_bytes[i]
+            << std::setw(12) << site.total_count << std::setw(14) << site.total_bytes << std::endl;
+    }
+}
+
+}
@@ -0,0 +1,117 @@
+#ifndef ASPIC_GC_PROFILER_HPP
+#define ASPIC_GC_PROFILER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+class BaseObject;
+
+namespace gc {
+
+/**
+ * Allocation-site heap profiler (opt-in, see --heap-profile).
+ *
+ * Syntax nodes which may allocate (array and hashmap literals, function
+ * calls, + and * operators) are registered as allocation sites, with their
+ * source line. While such a node is evaluated it is the current site, and
+ * each shared object created meanwhile is tagged with it.
+ *
+ * Cumulative counts are updated at allocation. Live counts are computed
+ * from the heap when the report is printed. Large strings are values,
+ * copied along with their Object, so they are only counted cumulatively.
+ */
+class Profiler
+{
+public:
+    static void enable();
+
+    static inline bool enabled()
+    {
+        return enabled_;
+    }
+
+    /**
+     * Register an allocation site
+     * @param label: what allocates (array literal, function name, ...)
+     * @param line: source line number
+     * @return site ID, or 0 if profiling is disabled
+     */
+    static uint32_t register_site(const std::string& label, int line);
+
+    /**
+     * Make a site current for the lifetime of the scope
+     */
+    class Scope
+    {
+    public:
+        inline Scope(uint32_t site):
+            site_(site),
+            previous_(current_site_)
+        {
+            if (site_ != 0) {
+                current_site_ = site_;
+            }
+        }
+
+        inline ~Scope()
+        {
+            if (site_ != 0) {
+                current_site_ = previous_;
+            }
+        }
+
+    private:
+        uint32_t site_;
+        uint32_t previous_;
+    };
+
+    /**
+     * Tag a new shared object with the current site
+     */
+    static void record_object(BaseObject* object);
+
+    /**
+     * Count a new string, if large enough
+     */
+    static inline void record_string(size_t size)
+    {
+        if (enabled_ && size >= LARGE_STRING) {
+            record_large_string(size);
+        }
+    }
+
+    /**
+     * Print live and cumulative bytes per site, sorted by live bytes
+     */
+    static void report(std::ostream& os);
+
+    // Minimum size of strings tracked by the profiler
+    static const size_t LARGE_STRING = 1024;
+
+private:
+    Profiler() = delete;
+
+    static void record_large_string(size_t size);
+
+    struct Site
+    {
+        std::string label;
+        int line;
+        size_t total_count;
+        size_t total_bytes;
+    };
+
+    static bool enabled_;
+    static uint32_t current_site_;
+    static std::vector<Site> sites_; // index 0: objects allocated outside of any site
+    static std::map<std::pair<std::string, int>, uint32_t> site_ids_;
+};
+
+}
+
+#endif
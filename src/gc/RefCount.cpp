@@ -0,0 +1,217 @@
+#include "gc/RefCount.hpp"
+#include "gc/Visitor.hpp"
+#include "Object.hpp"
+#include "Metrics.hpp"
+
+namespace gc {
+
+// Init static attributes
+bool                     RefCount::enabled_ = false;
+bool                     RefCount::collecting_ = false;
+bool                     RefCount::destroying_ = false;
+std::vector<BaseObject*> RefCount::roots_;
+std::vector<BaseObject*> RefCount::pending_;
+
+namespace {
+
+/**
+ * Collect the shared objects directly referenced by an object
+ */
+class ChildCollector: public Visitor
+{
+public:
+    void collect(BaseObject* object)
+    {
+        children.clear();
+        object->gc_visit(*this);
+    }
+
+    void visit(Object& object) override
+    {
+        children.push_back(object.get_shared_object());
+    }
+
+    std::vector<BaseObject*> children;
+};
+
+}
+
+
+void RefCount::enable()
+{
+    enabled_ = true;
+}
+
+void RefCount::disable()
+{
+    enabled_ = false;
+    roots_.clear();
+}
+
+void RefCount::release(BaseObject* object)
+{
+    // Garbage cycles are destroyed without decrementing the counts again
+    if (collecting_) {
+        return;
+    }
+    if (--object->ref_count_ == 0) {
+        destroy(object);
+    }
+    else {
+        object->rc_color_ = PURPLE;
+        if (object->rc_buffer_index_ == NOT_BUFFERED) {
+            object->rc_buffer_index_ = roots_.size();
+            roots_.push_back(object);
+        }
+    }
+}
+
+void RefCount::destroy(BaseObject* object)
+{
+    unbuffer(object);
+    // Destructors release children: the nested destructions are queued
+    // instead of recursing, so long chains cannot overflow the stack
+    if (destroying_) {
+        pending_.push_back(object);
+        return;
+    }
+    destroying_ = true;
+    delete object;
+    while (!pending_.empty()) {
+        BaseObject* next = pending_.back();
+        pending_.pop_back();
+        delete next;
+    }
+    destroying_ = false;
+}
+
+void RefCount::unbuffer(BaseObject* object)
+{
+    if (object->rc_buffer_index_ != NOT_BUFFERED) {
+        roots_[object->rc_buffer_index_] = nullptr;
+        object->rc_buffer_index_ = NOT_BUFFERED;
+    }
+}
+
+void RefCount::relocate(BaseObject* object, BaseObject* moved)
+{
+    if (object->rc_buffer_index_ != NOT_BUFFERED) {
+        roots_[object->rc_buffer_index_] = moved;
+    }
+}
+
+size_t RefCount::collect_cycles()
+{
+    Metrics::Clock::time_point start = Metrics::Clock::now();
+    std::vector<BaseObject*> candidates;
+    for (BaseObject* object: roots_) {
+        if (object != nullptr) {
+            object->rc_buffer_index_ = NOT_BUFFERED;
+            if (object->rc_color_ == PURPLE) {
+                candidates.push_back(object);
+            }
+        }
+    }
+    roots_.clear();
+
+    // Trial deletion: remove internal references within candidate subgraphs,
+    // objects still referenced from outside are restored
+    for (BaseObject* object: candidates) {
+        mark_gray(object);
+    }
+    for (BaseObject* object: candidates) {
+        scan(object);
+    }
+    std::vector<BaseObject*> garbage;
+    for (BaseObject* object: candidates) {
+        collect_white(object, garbage);
+    }
+
+    collecting_ = true;
+    for (BaseObject* object: garbage) {
+        delete object;
+    }
+    collecting_ = false;
+    Metrics::record_gc(Metrics::Clock::now() - start);
+    return garbage.size();
+}
+
+void RefCount::mark_gray(BaseObject* object)
+{
+    ChildCollector collector;
+    std::vector<BaseObject*> stack(1, object);
+    while (!stack.empty()) {
+        BaseObject* current = stack.back();
+        stack.pop_back();
+        if (current->rc_color_ == GRAY) {
+            continue;
+        }
+        current->rc_color_ = GRAY;
+        collector.collect(current);
+        for (BaseObject* child: collector.children) {
+            --child->ref_count_;
+            if (child->rc_color_ != GRAY) {
+                stack.push_back(child);
+            }
+        }
+    }
+}
+
+void RefCount::scan(BaseObject* object)
+{
+    ChildCollector collector;
+    std::vector<BaseObject*> stack(1, object);
+    while (!stack.empty()) {
+        BaseObject* current = stack.back();
+        stack.pop_back();
+        if (current->rc_color_ != GRAY) {
+            continue;
+        }
+        if (current->ref_count_ > 0) {
+            scan_black(current);
+        }
+        else {
+            current->rc_color_ = WHITE;
+            collector.collect(current);
+            stack.insert(stack.end(), collector.children.begin(), collector.children.end());
+        }
+    }
+}
+
+void RefCount::scan_black(BaseObject* object)
+{
+    ChildCollector collector;
+    object->rc_color_ = BLACK;
+    std::vector<BaseObject*> stack(1, object);
+    while (!stack.empty()) {
+        BaseObject* current = stack.back();
+        stack.pop_back();
+        collector.collect(current);
+        for (BaseObject* child: collector.children) {
+            ++child->ref_count_;
+            if (child->rc_color_ != BLACK) {
+                child->rc_color_ = BLACK;
+                stack.push_back(child);
+            }
+        }
+    }
+}
+
+void RefCount::collect_white(BaseObject* object, std::vector<BaseObject*>& garbage)
+{
+    ChildCollector collector;
+    std::vector<BaseObject*> stack(1, object);
+    while (!stack.empty()) {
+        BaseObject* current = stack.back();
+        stack.pop_back();
+        if (current->rc_color_ != WHITE || current->rc_buffer_index_ != NOT_BUFFERED) {
+            continue;
+        }
+        current->rc_color_ = BLACK;
+        garbage.push_back(current);
+        collector.collect(current);
+        stack.insert(stack.end(), collector.children.begin(), collector.children.end());
+    }
+}
+
+}
@@ -0,0 +1,110 @@
+#ifndef ASPIC_GC_REFCOUNT_HPP
+#define ASPIC_GC_REFCOUNT_HPP
+
+#include "BaseObject.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gc {
+
+/**
+ * Alternative memory mode: shared objects are reference counted through
+ * Object copy, assignment and destruction, and freed as soon as the last
+ * reference is dropped.
+ *
+ * Reference cycles (self-containing arrays, ...) are reclaimed by a
+ * synchronous trial deletion collector (Bacon & Rajan): objects whose count
+ * was decremented to a non-zero value are buffered as possible cycle roots,
+ * and the collector checks whether their subgraph is only referenced from
+ * itself.
+ */
+class RefCount
+{
+public:
+    /**
+     * Switch to reference counting. Must be called before any shared object
+     * is created.
+     */
+    static void enable();
+
+    /**
+     * Go back to tracing only: counts are no longer updated
+     */
+    static void disable();
+
+    static inline bool enabled()
+    {
+        return enabled_;
+    }
+
+    static inline void retain(BaseObject* object)
+    {
+        ++object->ref_count_;
+        object->rc_color_ = BLACK;
+    }
+
+    /**
+     * Drop a reference: object is destroyed if it was the last one,
+     * otherwise it's buffered as a possible cycle root
+     */
+    static void release(BaseObject* object);
+
+    /**
+     * Update the possible roots buffer after an object has been moved
+     * by heap compaction
+     */
+    static void relocate(BaseObject* object, BaseObject* moved);
+
+    /**
+     * Reclaim garbage cycles among buffered objects
+     * @return number of destroyed objects
+     */
+    static size_t collect_cycles();
+
+    /**
+     * Called between expressions, where no container is being modified:
+     * collect cycles if enough possible roots have been buffered
+     */
+    static inline void safepoint()
+    {
+        if (enabled_ && roots_.size() >= CYCLE_THRESHOLD) {
+            collect_cycles();
+        }
+    }
+
+    // Number of buffered roots which triggers a cycle collection
+    static const size_t CYCLE_THRESHOLD = 10000;
+
+private:
+    RefCount() = delete;
+
+    enum Color
+    {
+        BLACK,  // in use
+        GRAY,   // possible member of a cycle
+        WHITE,  // member of a garbage cycle
+        PURPLE, // possible root of a cycle
+    };
+
+    static const uint32_t NOT_BUFFERED = UINT32_MAX;
+
+    static void destroy(BaseObject* object);
+    static void unbuffer(BaseObject* object);
+
+    static void mark_gray(BaseObject* object);
+    static void scan(BaseObject* object);
+    static void scan_black(BaseObject* object);
+    static void collect_white(BaseObject* object, std::vector<BaseObject*>& garbage);
+
+    static bool enabled_;
+    static bool collecting_;
+    static bool destroying_;
+    static std::vector<BaseObject*> roots_;
+    static std::vector<BaseObject*> pending_;
+};
+
+}
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef ASPIC_GC_VISITOR_HPP
+#define ASPIC_GC_VISITOR_HPP
+
+class Object;
+
+namespace gc {
+
+/**
+ * Interface for walking the object graph: BaseObject::gc_visit invokes the
+ * visitor on each Object value it holds which references a shared object
+ */
+class Visitor
+{
+public:
+    virtual ~Visitor() {}
+
+    virtual void visit(Object& object) = 0;
+};
+
+}
+
+#endif
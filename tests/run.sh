@@ -14,3 +14,14 @@ for i in $(find ./tests -name "*_test.txt" -type f | sort); do
         exit 1
     fi
 done
+
+# Sessions are fed to the interactive shell, which goes on after errors:
+# they pass if the shell exits normally and no assertion fails
+for i in $(find ./tests -name "*_session.txt" -type f | sort); do
+    if output=$(valgrind ./aspic < $i) && ! echo "$output" | grep -q "AssertionError"; then
+        echo ${C_GREEN} PASS ${C_NONE} $i
+    else
+        echo ${C_RED} FAIL ${C_NONE} $i
+        exit 1
+    fi
+done